@@ -20,13 +20,19 @@
  */
 
 #include "CollisionInfo.hpp"
+#include "geometry/matrix/Transformation.hpp"
 
 namespace poxelcoll {
 
 CollisionInfo::CollisionInfo(const std::shared_ptr<const Mask> aMask, const P aPosition, const double aAngle,
 		const double aScaleX, const double aScaleY, const int aId):
 			mask(aMask), position(aPosition), angle(aAngle),
-			scaleX(aScaleX), scaleY(aScaleY), id(aId) {
+			scaleX(aScaleX), scaleY(aScaleY), id(aId),
+			transformation(Transformation::getAffineTransformation((*aMask).origin(), aPosition, aAngle, aScaleX, aScaleY)),
+			inverseTransformation(transformation.hasInverse() ?
+					Transformation::getInverseAffineTransformationUnsafe((*aMask).origin(), aPosition, aAngle, aScaleX, aScaleY) :
+					Affine::identity()),
+			boundingBox(Transformation::getTightBoundingBox(*(*(*aMask).convexHull()).points(), transformation)) {
 }
 
 const std::shared_ptr<const Mask> CollisionInfo::gMask() const {
@@ -53,4 +59,16 @@ const int CollisionInfo::gId() const {
 	return id;
 }
 
+const Affine & CollisionInfo::gTransformation() const {
+	return transformation;
+}
+
+const Affine & CollisionInfo::gInverseTransformation() const {
+	return inverseTransformation;
+}
+
+const BoundingBox & CollisionInfo::gBoundingBox() const {
+	return boundingBox;
+}
+
 }
@@ -22,7 +22,9 @@
 #ifndef POXELCOLL_COLLISIONINFO_HPP_
 #define POXELCOLL_COLLISIONINFO_HPP_
 
+#include "DataTypes.hpp"
 #include "mask/Mask.hpp"
+#include "geometry/matrix/Affine.hpp"
 
 namespace poxelcoll {
 
@@ -33,6 +35,10 @@ namespace poxelcoll {
  * The order of transformation is: origin, scaling, rotation, position.
  *
  * Angle is in radians, position is in pixels, and the scaling factors are percentages (where 1.0 == 100%).
+ *
+ * The affine transformation and its inverse, and the axis-aligned bounding box of the transformed convex hull of the mask,
+ * are found once, when the collision info is created. Since a new collision info is given for every object every frame,
+ * this caches them per object per frame, for the broad phases and the pairwise collision detection alike.
  */
 class CollisionInfo {
 private:
@@ -42,6 +48,9 @@ private:
 	const double scaleX;
 	const double scaleY;
 	const int id;
+	const Affine transformation;
+	const Affine inverseTransformation; //NOTE: Only valid if the transformation has an inverse.
+	const BoundingBox boundingBox;
 
 public:
 	CollisionInfo(const std::shared_ptr<const Mask> aMask, const P aPosition, const double aAngle,
@@ -60,6 +69,17 @@ public:
 	const double gScaleY() const;
 
 	const int gId() const;
+
+	/** The affine transformation of the mask, see Transformation::getAffineTransformation. */
+	const Affine & gTransformation() const;
+
+	/** The inverse of the affine transformation of the mask, found in closed form,
+	  * see Transformation::getInverseAffineTransformationUnsafe. Only valid if the transformation has an inverse.
+	  */
+	const Affine & gInverseTransformation() const;
+
+	/** The axis-aligned bounding box of the transformed convex hull of the mask, see Transformation::getTightBoundingBox. */
+	const BoundingBox & gBoundingBox() const;
 };
 
 }
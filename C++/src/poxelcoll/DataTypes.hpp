@@ -187,6 +187,14 @@ public:
 	const int id2;
 public:
 
+	struct Comparer {
+	  bool operator() (const poxelcoll::CollisionPair & lhs, const poxelcoll::CollisionPair & rhs) const
+	  {
+		  return lhs.id1 < rhs.id1 || (lhs.id1 == rhs.id1 && lhs.id2 < rhs.id2);
+	  }
+	};
+public:
+
 	/** Creation of collision pair. This method is the preferred way of creating collision pairs.
 	 *
 	 * @param id1 first id
@@ -68,6 +68,24 @@ public:
 	 */
 	virtual const bool hasPoint(unsigned int x, unsigned int y) const = 0;
 
+	/** Whether any point in a span of a row is on.
+	 *
+	 * The default implementation tests each point, but implementations may test whole spans at once.
+	 *
+	 * @param y value in the range [0; height[
+	 * @param xMin value in the range [0; width[
+	 * @param xMax value in the range [xMin; width[, inclusive
+	 * @return whether any of the points (x, y) for x in [xMin; xMax] is on. Behaviour is undefined if outside range
+	 */
+	virtual const bool hasPointInRow(unsigned int y, unsigned int xMin, unsigned int xMax) const {
+		for (auto x = xMin; x <= xMax; x++) {
+			if (hasPoint(x, y)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 };
 
 }
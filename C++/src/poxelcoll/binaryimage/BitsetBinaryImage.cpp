@@ -25,14 +25,21 @@ namespace poxelcoll {
 
 BitsetBinaryImage::BitsetBinaryImage(const boost::dynamic_bitset<>* imSourRs,
 		const unsigned int width, const unsigned int height) :
-		myWidth(width), myHeight(height) {
-	imageSourceRows = imSourRs;
-}
-;
+		myWidth(width), myHeight(height),
+		myWordsPerRow((width + bitsPerWord - 1) / bitsPerWord),
+		words(myWordsPerRow * height, 0) {
+
+	for (unsigned int y = 0; y < height; y++) {
+		for (unsigned int x = 0; x < width; x++) {
+			if ((*imSourRs)[x + y * width]) {
+				words[y * myWordsPerRow + x / bitsPerWord] |= ((Word) 1) << (x % bitsPerWord);
+			}
+		}
+	}
 
-BitsetBinaryImage::~BitsetBinaryImage() {
-	delete imageSourceRows;
+	delete imSourRs;
 }
+
 const unsigned int BitsetBinaryImage::width() const {
 	return myWidth;
 }
@@ -40,8 +47,29 @@ const unsigned int BitsetBinaryImage::height() const {
 	return myHeight;
 }
 
-const bool BitsetBinaryImage::hasPoint(unsigned int x, unsigned int y) const {
-	return (*imageSourceRows)[x + y * myWidth];
+const bool BitsetBinaryImage::hasPointInRow(unsigned int y, unsigned int xMin, unsigned int xMax) const {
+
+	const auto rowWords = row(y);
+	const auto first = xMin / bitsPerWord;
+	const auto last = xMax / bitsPerWord;
+
+	for (auto i = first; i <= last; i++) {
+
+		auto word = rowWords[i];
+
+		if (i == first) { //Remove the points before the span.
+			word &= ~((Word) 0) << (xMin % bitsPerWord);
+		}
+		if (i == last && xMax % bitsPerWord != bitsPerWord - 1) { //Remove the points after the span.
+			word &= (((Word) 1) << (xMax % bitsPerWord + 1)) - 1;
+		}
+
+		if (word != 0) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 const BinaryImage* BitsetBinaryImageFactory::createNull(
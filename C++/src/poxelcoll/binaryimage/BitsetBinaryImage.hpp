@@ -25,6 +25,9 @@
 #include <bitset>
 #include <deque>
 #include <memory>
+#include <vector>
+
+#include <stdint.h>
 
 #include <boost/dynamic_bitset.hpp>
 
@@ -44,25 +47,79 @@ namespace poxelcoll {
  * Notably, a bitset generally requires relatively very little memory,
  * while accessing points is a bit more expensive compared to other methods.
  * See for instance http://en.wikipedia.org/wiki/Bitset.
+ *
+ * The bits are packed row by row into 64-bit words, such that each row starts at a new word.
+ * Bit number i (counting from the least significant bit) of word number j in a row is the pixel at x = 64*j + i,
+ * and the bits after the last pixel of a row are always off.
+ * This allows whole rows to be compared 64 pixels at a time.
  */
 class BitsetBinaryImage: public virtual BinaryImage {
 
+public:
+
+	typedef uint64_t Word;
+
+	static const unsigned int bitsPerWord = 64;
+
 private:
 
-	const boost::dynamic_bitset<>* imageSourceRows;
 	const unsigned int myWidth;
 	const unsigned int myHeight;
+	const unsigned int myWordsPerRow;
+	std::vector<Word> words;
 
 public:
 
+	/** The image takes ownership of the bitset, which is deleted once its contents have been packed.
+	 *
+	 * @param imSourRs bitset where the pixel (x, y) is at index x + y * width
+	 * @param width strictly positive width
+	 * @param height strictly positive height
+	 */
 	BitsetBinaryImage(const boost::dynamic_bitset<>* imSourRs,
 			const unsigned int width, const unsigned int height);
 
-	~BitsetBinaryImage();
 	const unsigned int width() const;
 	const unsigned int height() const;
 
-	const bool hasPoint(unsigned int x, unsigned int y) const;
+	const bool hasPoint(unsigned int x, unsigned int y) const {
+		return (words[y * myWordsPerRow + x / bitsPerWord] >> (x % bitsPerWord)) & 1;
+	}
+
+	const bool hasPointInRow(unsigned int y, unsigned int xMin, unsigned int xMax) const;
+
+	/** @return the number of words each row is packed into */
+	const unsigned int wordsPerRow() const {
+		return myWordsPerRow;
+	}
+
+	/** @param y value in the range [0; height[
+	 * @return the packed words of the row, wordsPerRow() of them
+	 */
+	const Word* row(const unsigned int y) const {
+		return words.data() + y * myWordsPerRow;
+	}
+
+	/** The points of a part of a row, as the bits of a word.
+	 *
+	 * @param y value in the range [0; height[
+	 * @param xMin the first point of the part
+	 * @param count the number of points in the part, in the range [1; 64], such that xMin + count <= width
+	 * @return the word where bit number i (counting from the least significant bit) is the point at x = xMin + i
+	 */
+	const Word rowBits(const unsigned int y, const unsigned int xMin, const unsigned int count) const {
+
+		const auto rowWords = row(y);
+		const auto index = xMin / bitsPerWord;
+		const auto shift = xMin % bitsPerWord;
+
+		auto result = rowWords[index] >> shift;
+		if (shift != 0 && index + 1 < myWordsPerRow) {
+			result |= rowWords[index + 1] << (bitsPerWord - shift);
+		}
+
+		return count == bitsPerWord ? result : result & ((((Word) 1) << count) - 1);
+	}
 
 	static BitsetBinaryImage* createUnsafe(int width, int height,
 			boost::dynamic_bitset<>* imageSourceRows) {
@@ -0,0 +1,131 @@
+/* OccupancyPyramid.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OccupancyPyramid.hpp"
+
+namespace poxelcoll {
+
+OccupancyPyramid::OccupancyPyramid(const BinaryImage & binaryImage) {
+
+	Level image(binaryImage.width(), binaryImage.height());
+	for (unsigned int y = 0; y < image.height; y++) {
+		for (unsigned int x = 0; x < image.width; x++) {
+			if (binaryImage.hasPoint(x, y)) {
+				image.cells[x + y * image.width] = 1;
+			}
+		}
+	}
+	levels.push_back(image);
+
+	//Pool the 2x2 blocks until there is a single cell left.
+
+	while (levels.back().width > 1 || levels.back().height > 1) {
+
+		const auto & below = levels.back();
+		Level above((below.width + 1) / 2, (below.height + 1) / 2);
+
+		for (unsigned int y = 0; y < below.height; y++) {
+			for (unsigned int x = 0; x < below.width; x++) {
+				if (below.has(x, y)) {
+					above.cells[x / 2 + (y / 2) * above.width] = 1;
+				}
+			}
+		}
+
+		levels.push_back(above);
+	}
+}
+
+const unsigned int OccupancyPyramid::levelCount() const {
+	return levels.size();
+}
+
+const bool OccupancyPyramid::hasPointIn(const unsigned int level, const unsigned int x, const unsigned int y,
+		const int xMin, const int yMin, const int xMax, const int yMax) const {
+
+	if (!levels[level].has(x, y)) {
+		return false;
+	}
+
+	//The pixels the cell covers.
+
+	const int cellXMin = x << level;
+	const int cellYMin = y << level;
+	const int cellXMax = ((x + 1) << level) - 1;
+	const int cellYMax = ((y + 1) << level) - 1;
+
+	if (cellXMax < xMin || cellXMin > xMax || cellYMax < yMin || cellYMin > yMax) { //Outside the rectangle.
+		return false;
+	}
+	else if (cellXMin >= xMin && cellXMax <= xMax && cellYMin >= yMin && cellYMax <= yMax) { //Inside the rectangle.
+		return true;
+	}
+	else { //Partly inside, and therefore not at the image level, so look at the cells below.
+
+		const auto & below = levels[level - 1];
+
+		for (unsigned int childY = 2 * y; childY <= 2 * y + 1 && childY < below.height; childY++) {
+			for (unsigned int childX = 2 * x; childX <= 2 * x + 1 && childX < below.width; childX++) {
+				if (hasPointIn(level - 1, childX, childY, xMin, yMin, xMax, yMax)) {
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
+
+const bool OccupancyPyramid::hasPointIn(const int xMin, const int yMin, const int xMax, const int yMax) const {
+
+	const auto & image = levels.front();
+
+	const auto xFrom = xMin > 0 ? xMin : 0;
+	const auto yFrom = yMin > 0 ? yMin : 0;
+	const auto xTo = xMax < (int) image.width - 1 ? xMax : (int) image.width - 1;
+	const auto yTo = yMax < (int) image.height - 1 ? yMax : (int) image.height - 1;
+
+	if (xFrom > xTo || yFrom > yTo) {
+		return false;
+	}
+	else {
+
+		//Start at the lowest level where the rectangle spans at most 2x2 cells, instead of at the top.
+
+		const auto extent = (xTo - xFrom > yTo - yFrom ? xTo - xFrom : yTo - yFrom) + 1;
+		unsigned int level = 0;
+		while ((1 << level) < extent && level + 1 < levels.size()) {
+			level++;
+		}
+
+		for (unsigned int y = yFrom >> level; y <= (unsigned int) yTo >> level; y++) {
+			for (unsigned int x = xFrom >> level; x <= (unsigned int) xTo >> level; x++) {
+				if (hasPointIn(level, x, y, xFrom, yFrom, xTo, yTo)) {
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
+
+}
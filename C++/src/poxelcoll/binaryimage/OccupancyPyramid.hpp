@@ -0,0 +1,92 @@
+/* OccupancyPyramid.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_BINARYIMAGE_OCCUPANCYPYRAMID_HPP_
+#define POXELCOLL_BINARYIMAGE_OCCUPANCYPYRAMID_HPP_
+
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "BinaryImage.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollbinaryimage
+ *
+ * An occupancy pyramid of a binary image, which supports quickly finding out whether
+ * any point in a rectangle of the image is on.
+ *
+ * The first level is the binary image itself. Each following level has half the width and height
+ * (rounded up) of the level below, and a cell in it is on exactly when any of the 2x2 cells below it is on.
+ * The last level has a single cell, which is on exactly when the image has any point on.
+ *
+ * The pyramid takes about a third more memory than the bits of the image.
+ */
+class OccupancyPyramid {
+
+private:
+
+	struct Level {
+		unsigned int width;
+		unsigned int height;
+		boost::dynamic_bitset<> cells; //The cell (x, y) is at index x + y * width.
+
+		Level(const unsigned int aWidth, const unsigned int aHeight) :
+			width(aWidth), height(aHeight), cells(aWidth * aHeight) {
+		}
+
+		const bool has(const unsigned int x, const unsigned int y) const {
+			return cells[x + y * width];
+		}
+	};
+
+	std::vector<Level> levels;
+
+	/** Whether any point on within the cell (x, y) at the given level is also within the rectangle. */
+	const bool hasPointIn(const unsigned int level, const unsigned int x, const unsigned int y,
+			const int xMin, const int yMin, const int xMax, const int yMax) const;
+
+public:
+
+	/** @param binaryImage the binary image, of which the occupancy is copied
+	 */
+	OccupancyPyramid(const BinaryImage & binaryImage);
+
+	/** @return the number of levels, including the image itself */
+	const unsigned int levelCount() const;
+
+	/** Whether any point within the rectangle is on in the image.
+	 *
+	 * The rectangle may extend outside the image, the part outside is ignored.
+	 *
+	 * @param xMin the first column of the rectangle
+	 * @param yMin the first row of the rectangle
+	 * @param xMax the last column of the rectangle, inclusive
+	 * @param yMax the last row of the rectangle, inclusive
+	 * @return whether any point in the rectangle is on
+	 */
+	const bool hasPointIn(const int xMin, const int yMin, const int xMax, const int yMax) const;
+};
+
+}
+
+#endif /* POXELCOLL_BINARYIMAGE_OCCUPANCYPYRAMID_HPP_ */
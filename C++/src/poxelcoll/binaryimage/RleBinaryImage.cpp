@@ -0,0 +1,136 @@
+/* RleBinaryImage.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "RleBinaryImage.hpp"
+
+namespace poxelcoll {
+
+RleBinaryImage::RleBinaryImage(const unsigned int width, const unsigned int height,
+		const std::vector<Run> & aRuns, const std::vector<unsigned int> & aRowStarts) :
+		myWidth(width), myHeight(height), runs(aRuns), rowStarts(aRowStarts) {
+}
+
+const unsigned int RleBinaryImage::width() const {
+	return myWidth;
+}
+
+const unsigned int RleBinaryImage::height() const {
+	return myHeight;
+}
+
+const bool RleBinaryImage::hasPoint(unsigned int x, unsigned int y) const {
+	return hasPointInRow(y, x, x);
+}
+
+const bool RleBinaryImage::hasPointInRow(unsigned int y, unsigned int xMin, unsigned int xMax) const {
+
+	const auto rowBegin = runs.begin() + rowStarts[y];
+	const auto rowEnd = runs.begin() + rowStarts[y + 1];
+
+	//The first run that does not end before the span. The span has a point on iff that run starts within it.
+
+	const auto found = std::lower_bound(rowBegin, rowEnd, xMin,
+		[](const Run & run, const unsigned int x) {
+			return run.end < x;
+		}
+	);
+
+	return found != rowEnd && (*found).start <= xMax;
+}
+
+const uint64_t RleBinaryImage::rowBits(const unsigned int y, const unsigned int xMin, const unsigned int count) const {
+
+	const auto rowBegin = runs.begin() + rowStarts[y];
+	const auto rowEnd = runs.begin() + rowStarts[y + 1];
+	const auto xEnd = xMin + count; //Exclusive.
+
+	auto run = std::lower_bound(rowBegin, rowEnd, xMin,
+		[](const Run & run, const unsigned int x) {
+			return run.end < x;
+		}
+	);
+
+	uint64_t result = 0;
+
+	for (; run != rowEnd && (*run).start < xEnd; run++) {
+
+		const auto first = (*run).start > xMin ? (*run).start : xMin;
+		const auto last = (*run).end + 1 < xEnd ? (*run).end + 1 : xEnd; //Exclusive.
+		const auto length = last - first;
+
+		const auto bits = length == 64 ? ~((uint64_t) 0) : (((uint64_t) 1) << length) - 1;
+		result |= bits << (first - xMin);
+	}
+
+	return result;
+}
+
+const unsigned int RleBinaryImage::runCount() const {
+	return runs.size();
+}
+
+const BinaryImage* RleBinaryImageFactory::createNull(
+		const std::deque<std::deque<bool>>& imageSourceRows) const {
+
+	const auto height = imageSourceRows.size();
+	if (height < 1) {
+		std::cerr << "Invalid height" << std::endl;
+		return 0;
+	} else {
+		const auto firstRow = imageSourceRows[0]; //Size is at least 1, so this is fine.
+		const auto width = firstRow.size();
+
+		if (exists(imageSourceRows,
+				[&width](std::deque<bool> a) {return a.size() != width;})) {
+			std::cerr << "Not the same length" << std::endl;
+			return 0;
+		} else {
+
+			std::vector<RleBinaryImage::Run> runs;
+			std::vector<unsigned int> rowStarts;
+
+			for (unsigned int y = 0; y < height; y++) {
+
+				rowStarts.push_back(runs.size());
+
+				const auto & row = imageSourceRows[y];
+				unsigned int x = 0;
+				while (x < width) {
+					if (row[x]) {
+						const auto start = x;
+						while (x + 1 < width && row[x + 1]) {
+							x++;
+						}
+						runs.push_back(RleBinaryImage::Run(start, x));
+					}
+					x++;
+				}
+			}
+			rowStarts.push_back(runs.size());
+
+			return new RleBinaryImage(width, height, runs, rowStarts);
+		}
+	}
+}
+
+}
@@ -0,0 +1,113 @@
+/* RleBinaryImage.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_BINARYIMAGE_RLEBINARYIMAGE_HPP_
+#define POXELCOLL_BINARYIMAGE_RLEBINARYIMAGE_HPP_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <stdint.h>
+
+#include "BinaryImage.hpp"
+#include "BinaryImageFactory.hpp"
+
+#include "../functional/Functional.hpp"
+
+using namespace poxelcoll::functional;
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollbinaryimage
+ *
+ * A binary image that stores each row as a sorted sequence of runs of points that are on.
+ *
+ * The memory used is proportional to the number of runs, not the area, which suits images
+ * that consist of long solid runs, such as level geometry.
+ * Both single points and whole spans of a row are tested by a binary search among the runs of the row,
+ * so a span costs about the same as a single point.
+ */
+class RleBinaryImage: public virtual BinaryImage {
+
+public:
+
+	/** A run of points that are on, from start to end, both inclusive. */
+	struct Run {
+		unsigned int start;
+		unsigned int end;
+
+		Run(const unsigned int aStart, const unsigned int aEnd) :
+			start(aStart), end(aEnd) {
+		}
+	};
+
+private:
+
+	const unsigned int myWidth;
+	const unsigned int myHeight;
+	const std::vector<Run> runs; //The runs of all rows, row by row, each row sorted and non-overlapping.
+	const std::vector<unsigned int> rowStarts; //The runs of row y are [rowStarts[y]; rowStarts[y + 1][.
+
+public:
+
+	/** @param width strictly positive width
+	 * @param height strictly positive height
+	 * @param aRuns the runs of all rows, row by row, each row sorted and non-overlapping
+	 * @param aRowStarts the index of the first run of each row, followed by the number of runs
+	 */
+	RleBinaryImage(const unsigned int width, const unsigned int height,
+			const std::vector<Run> & aRuns, const std::vector<unsigned int> & aRowStarts);
+
+	const unsigned int width() const;
+	const unsigned int height() const;
+
+	const bool hasPoint(unsigned int x, unsigned int y) const;
+
+	const bool hasPointInRow(unsigned int y, unsigned int xMin, unsigned int xMax) const;
+
+	/** The points of a part of a row, as the bits of a word.
+	 *
+	 * @param y value in the range [0; height[
+	 * @param xMin the first point of the part
+	 * @param count the number of points in the part, in the range [1; 64], such that xMin + count <= width
+	 * @return the word where bit number i (counting from the least significant bit) is the point at x = xMin + i
+	 */
+	const uint64_t rowBits(const unsigned int y, const unsigned int xMin, const unsigned int count) const;
+
+	/** @return the number of runs in all the rows */
+	const unsigned int runCount() const;
+};
+
+/** \ingroup poxelcollbinaryimage
+ *
+ * The factory for the run-length encoded binary image.
+ */
+class RleBinaryImageFactory: public virtual BinaryImageFactory {
+
+public:
+	const BinaryImage* createNull(
+			const std::deque<std::deque<bool>>& imageSourceRows) const;
+};
+
+}
+
+#endif /* POXELCOLL_BINARYIMAGE_RLEBINARYIMAGE_HPP_ */
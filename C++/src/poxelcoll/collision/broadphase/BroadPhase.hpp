@@ -0,0 +1,90 @@
+/* BroadPhase.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_BROADPHASE_BROADPHASE_HPP_
+#define POXELCOLL_COLLISION_BROADPHASE_BROADPHASE_HPP_
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "../../DataTypes.hpp"
+#include "../../CollisionInfo.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollisionbroadphase
+  *
+  * A set of collision pairs, ordered by the ids of the pairs.
+  */
+typedef std::set<CollisionPair, CollisionPair::Comparer> CollisionPairSet;
+
+/** \ingroup poxelcollcollisionbroadphase
+  *
+  * The changes to a set of collision pairs between two points in time,
+  * such as two consecutive frames.
+  *
+  * A pair is never both added and removed.
+  */
+class CollisionPairChanges {
+public:
+	const std::shared_ptr<const CollisionPairSet> added;
+	const std::shared_ptr<const CollisionPairSet> removed;
+public:
+
+	CollisionPairChanges(const std::shared_ptr<const CollisionPairSet> aAdded,
+			const std::shared_ptr<const CollisionPairSet> aRemoved) :
+			added(aAdded), removed(aRemoved) {
+	}
+};
+
+/** \ingroup poxelcollcollisionbroadphase
+  *
+  * The broad phase finds the pairs of collision objects that may collide.
+  *
+  * The broad phase is conservative: it may report pairs that do not collide,
+  * but it never leaves out a pair that the narrow phase would find to collide.
+  * The pairs found are meant to be given to a pairwise collision detection,
+  * such that the narrow phase only sees the pairs that are not obviously apart.
+  */
+class BroadPhase {
+
+public:
+	virtual ~BroadPhase() {
+
+	}
+
+	  /** Given a sequence of collision objects, find the pairs of them that may collide.
+	    *
+	    * The pairs refer to the ids of the collision objects.
+	    * Collision objects with the same id never form a pair.
+	    *
+	    * @param collInfos the collision objects
+	    * @return the deduplicated pairs of collision objects that may collide
+	    */
+	virtual const std::shared_ptr<const CollisionPairSet> findCandidatePairs(
+			const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) const = 0;
+
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_BROADPHASE_BROADPHASE_HPP_ */
@@ -0,0 +1,421 @@
+/* DynamicTreeBroadPhase.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DynamicTreeBroadPhase.hpp"
+
+namespace poxelcoll {
+
+DynamicTreeBroadPhase::DynamicTreeBroadPhase(const double aMargin) :
+		margin(aMargin), root(nullNode), freeList(nullNode) {
+
+	if (!(aMargin >= 0.0)) {
+		std::cerr << "The margin must be non-negative." << std::endl;
+		throw 1;
+	}
+}
+
+const DynamicTreeBroadPhase::Box DynamicTreeBroadPhase::boxOf(const std::shared_ptr<const CollisionInfo> collInfo) {
+
+	const auto & box = (*collInfo).gBoundingBox();
+
+	const Box result = { box.pMin.gX(), box.pMin.gY(), box.pMax.gX(), box.pMax.gY() };
+	return result;
+}
+
+const int DynamicTreeBroadPhase::allocateNode() {
+
+	int index;
+
+	if (freeList == nullNode) {
+		index = nodes.size();
+		nodes.push_back(Node());
+	}
+	else {
+		index = freeList;
+		freeList = nodes[index].parent;
+	}
+
+	auto & node = nodes[index];
+	node.parent = nullNode;
+	node.child1 = nullNode;
+	node.child2 = nullNode;
+	node.height = 0;
+	node.collInfo.reset();
+
+	return index;
+}
+
+void DynamicTreeBroadPhase::freeNode(const int node) {
+	nodes[node].parent = freeList;
+	nodes[node].height = -1;
+	nodes[node].collInfo.reset();
+	freeList = node;
+}
+
+void DynamicTreeBroadPhase::insertLeaf(const int leaf) {
+
+	if (root == nullNode) {
+		root = leaf;
+		nodes[root].parent = nullNode;
+		return;
+	}
+
+	//Find the best sibling, by descending towards the child that increases the perimeter the least.
+
+	const auto leafBox = nodes[leaf].box;
+	auto index = root;
+
+	while (!nodes[index].isLeaf()) {
+
+		const auto & node = nodes[index];
+		const auto child1 = node.child1;
+		const auto child2 = node.child2;
+
+		const auto perimeter = node.box.perimeter();
+		const auto combinedPerimeter = Box::combine(node.box, leafBox).perimeter();
+
+		//Cost of creating a new parent for this node and the new leaf.
+		const auto cost = 2.0 * combinedPerimeter;
+
+		//Minimum cost of pushing the leaf further down the tree.
+		const auto inheritanceCost = 2.0 * (combinedPerimeter - perimeter);
+
+		const auto descendCost = [this, &leafBox, inheritanceCost](const int child) {
+			const auto & childNode = nodes[child];
+			const auto childCombinedPerimeter = Box::combine(childNode.box, leafBox).perimeter();
+			if (childNode.isLeaf()) {
+				return childCombinedPerimeter + inheritanceCost;
+			}
+			else {
+				return childCombinedPerimeter - childNode.box.perimeter() + inheritanceCost;
+			}
+		};
+		const auto cost1 = descendCost(child1);
+		const auto cost2 = descendCost(child2);
+
+		if (cost < cost1 && cost < cost2) {
+			break;
+		}
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	const auto sibling = index;
+
+	//Create a new parent for the sibling and the leaf.
+
+	const auto oldParent = nodes[sibling].parent;
+	const auto newParent = allocateNode(); //NOTE: May move the nodes, so no references are kept over this.
+
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].box = Box::combine(leafBox, nodes[sibling].box);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent != nullNode) {
+		if (nodes[oldParent].child1 == sibling) {
+			nodes[oldParent].child1 = newParent;
+		}
+		else {
+			nodes[oldParent].child2 = newParent;
+		}
+	}
+	else {
+		root = newParent;
+	}
+
+	//Walk back up the tree, rebalancing and fixing the heights and boxes.
+
+	index = nodes[leaf].parent;
+	while (index != nullNode) {
+		index = balance(index);
+
+		auto & node = nodes[index];
+		node.height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+		node.box = Box::combine(nodes[node.child1].box, nodes[node.child2].box);
+
+		index = node.parent;
+	}
+}
+
+void DynamicTreeBroadPhase::removeLeaf(const int leaf) {
+
+	if (leaf == root) {
+		root = nullNode;
+		return;
+	}
+
+	const auto parent = nodes[leaf].parent;
+	const auto grandParent = nodes[parent].parent;
+	const auto sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grandParent != nullNode) {
+
+		//Destroy the parent and connect the sibling to the grand parent.
+		if (nodes[grandParent].child1 == parent) {
+			nodes[grandParent].child1 = sibling;
+		}
+		else {
+			nodes[grandParent].child2 = sibling;
+		}
+		nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		auto index = grandParent;
+		while (index != nullNode) {
+			index = balance(index);
+
+			auto & node = nodes[index];
+			node.height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+			node.box = Box::combine(nodes[node.child1].box, nodes[node.child2].box);
+
+			index = node.parent;
+		}
+	}
+	else {
+		root = sibling;
+		nodes[sibling].parent = nullNode;
+		freeNode(parent);
+	}
+}
+
+const int DynamicTreeBroadPhase::balance(const int iA) {
+
+	//Rotates the higher child of A up if the heights of its children differ by more than 1.
+
+	if (nodes[iA].isLeaf() || nodes[iA].height < 2) {
+		return iA;
+	}
+
+	const auto iB = nodes[iA].child1;
+	const auto iC = nodes[iA].child2;
+
+	const auto heightDifference = nodes[iC].height - nodes[iB].height;
+
+	//Replaces the child A of A's parent with the given node, or the root if A has no parent.
+	const auto replaceA = [this, iA](const int replacement) {
+		const auto parent = nodes[replacement].parent;
+		if (parent != nullNode) {
+			if (nodes[parent].child1 == iA) {
+				nodes[parent].child1 = replacement;
+			}
+			else {
+				nodes[parent].child2 = replacement;
+			}
+		}
+		else {
+			root = replacement;
+		}
+	};
+
+	if (heightDifference > 1) { //Rotate C up.
+
+		const auto iF = nodes[iC].child1;
+		const auto iG = nodes[iC].child2;
+
+		nodes[iC].child1 = iA;
+		nodes[iC].parent = nodes[iA].parent;
+		nodes[iA].parent = iC;
+		replaceA(iC);
+
+		const auto higher = nodes[iF].height > nodes[iG].height ? iF : iG;
+		const auto lower = higher == iF ? iG : iF;
+
+		nodes[iC].child2 = higher;
+		nodes[iA].child2 = lower;
+		nodes[lower].parent = iA;
+
+		nodes[iA].box = Box::combine(nodes[iB].box, nodes[lower].box);
+		nodes[iC].box = Box::combine(nodes[iA].box, nodes[higher].box);
+		nodes[iA].height = 1 + std::max(nodes[iB].height, nodes[lower].height);
+		nodes[iC].height = 1 + std::max(nodes[iA].height, nodes[higher].height);
+
+		return iC;
+	}
+	else if (heightDifference < -1) { //Rotate B up.
+
+		const auto iD = nodes[iB].child1;
+		const auto iE = nodes[iB].child2;
+
+		nodes[iB].child1 = iA;
+		nodes[iB].parent = nodes[iA].parent;
+		nodes[iA].parent = iB;
+		replaceA(iB);
+
+		const auto higher = nodes[iD].height > nodes[iE].height ? iD : iE;
+		const auto lower = higher == iD ? iE : iD;
+
+		nodes[iB].child2 = higher;
+		nodes[iA].child1 = lower;
+		nodes[lower].parent = iA;
+
+		nodes[iA].box = Box::combine(nodes[iC].box, nodes[lower].box);
+		nodes[iB].box = Box::combine(nodes[iA].box, nodes[higher].box);
+		nodes[iA].height = 1 + std::max(nodes[iC].height, nodes[lower].height);
+		nodes[iB].height = 1 + std::max(nodes[iA].height, nodes[higher].height);
+
+		return iB;
+	}
+	else {
+		return iA;
+	}
+}
+
+const bool DynamicTreeBroadPhase::setObject(const std::shared_ptr<const CollisionInfo> collInfo) {
+
+	const auto tightBox = boxOf(collInfo);
+	const auto id = (*collInfo).gId();
+	const auto found = leafOfId.find(id);
+
+	int leaf;
+
+	if (found != leafOfId.end()) {
+
+		leaf = (*found).second;
+		nodes[leaf].collInfo = collInfo;
+		nodes[leaf].tightBox = tightBox;
+
+		if (nodes[leaf].box.contains(tightBox)) {
+			return false; //Still inside the fattened box, so the tree is unchanged.
+		}
+		else {
+			removeLeaf(leaf);
+		}
+	}
+	else {
+		leaf = allocateNode();
+		nodes[leaf].collInfo = collInfo;
+		nodes[leaf].tightBox = tightBox;
+		leafOfId[id] = leaf;
+	}
+
+	const Box fatBox = { tightBox.minX - margin, tightBox.minY - margin,
+			tightBox.maxX + margin, tightBox.maxY + margin };
+	nodes[leaf].box = fatBox;
+
+	insertLeaf(leaf);
+
+	return true;
+}
+
+void DynamicTreeBroadPhase::removeObject(const int id) {
+
+	const auto found = leafOfId.find(id);
+
+	if (found != leafOfId.end()) {
+		const auto leaf = (*found).second;
+		leafOfId.erase(found);
+		removeLeaf(leaf);
+		freeNode(leaf);
+	}
+}
+
+const int DynamicTreeBroadPhase::height() const {
+	return root == nullNode ? 0 : nodes[root].height;
+}
+
+const std::shared_ptr<const CollisionPairSet> DynamicTreeBroadPhase::findCandidatePairs() const {
+
+	auto result = new CollisionPairSet();
+
+	for (auto i = leafOfId.begin(); i != leafOfId.end(); i++) {
+
+		const auto leaf = (*i).second;
+		const auto & leafNode = nodes[leaf];
+
+		query(leafNode.box, [this, leaf, &leafNode, result](const int other) {
+
+			//NOTE: Each pair is found from both of its leaves, so only the one with the lower index reports it.
+			if (leaf < other && leafNode.tightBox.intersects(nodes[other].tightBox)) {
+
+				const std::unique_ptr<const CollisionPair> pairNull(
+						CollisionPair::createNull((*leafNode.collInfo).gId(), (*nodes[other].collInfo).gId())); //NOTE: Handle null.
+
+				if (pairNull.get() != 0) {
+					result->insert(*pairNull);
+				}
+			}
+		});
+	}
+
+	return std::shared_ptr<const CollisionPairSet>(result);
+}
+
+const std::shared_ptr<const std::vector<std::shared_ptr<const CollisionInfo>>> DynamicTreeBroadPhase::queryRegion(
+		const BoundingBox & region) const {
+
+	const Box regionBox = { region.pMin.gX(), region.pMin.gY(), region.pMax.gX(), region.pMax.gY() };
+
+	auto result = new std::vector<std::shared_ptr<const CollisionInfo>>();
+
+	query(regionBox, [this, &regionBox, result](const int leaf) {
+		if (nodes[leaf].tightBox.intersects(regionBox)) {
+			result->push_back(nodes[leaf].collInfo);
+		}
+	});
+
+	return std::shared_ptr<const std::vector<std::shared_ptr<const CollisionInfo>>>(result);
+}
+
+const std::shared_ptr<const CollisionPairSet> DynamicTreeBroadPhase::findCollisions(const Pairwise & pairwise) const {
+
+	const auto candidatePairs = findCandidatePairs();
+
+	auto result = new CollisionPairSet();
+
+	for (auto i = (*candidatePairs).begin(); i != (*candidatePairs).end(); i++) {
+
+		const auto & collInfo1 = nodes[leafOfId.at((*i).id1)].collInfo;
+		const auto & collInfo2 = nodes[leafOfId.at((*i).id2)].collInfo;
+
+		if (pairwise.testForCollision(collInfo1, collInfo2)) {
+			result->insert(*i);
+		}
+	}
+
+	return std::shared_ptr<const CollisionPairSet>(result);
+}
+
+const std::shared_ptr<const std::vector<std::shared_ptr<const CollisionInfo>>> DynamicTreeBroadPhase::findCollisionsWith(
+		const std::shared_ptr<const CollisionInfo> collInfo, const Pairwise & pairwise) const {
+
+	const auto regionBox = boxOf(collInfo);
+	const auto id = (*collInfo).gId();
+
+	auto result = new std::vector<std::shared_ptr<const CollisionInfo>>();
+
+	query(regionBox, [this, &regionBox, id, collInfo, &pairwise, result](const int leaf) {
+
+		const auto & other = nodes[leaf].collInfo;
+
+		if ((*other).gId() != id && nodes[leaf].tightBox.intersects(regionBox)
+				&& pairwise.testForCollision(collInfo, other)) {
+			result->push_back(other);
+		}
+	});
+
+	return std::shared_ptr<const std::vector<std::shared_ptr<const CollisionInfo>>>(result);
+}
+
+}
@@ -0,0 +1,213 @@
+/* DynamicTreeBroadPhase.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_BROADPHASE_DYNAMICTREEBROADPHASE_HPP_
+#define POXELCOLL_COLLISION_BROADPHASE_DYNAMICTREEBROADPHASE_HPP_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "BroadPhase.hpp"
+#include "../pairwise/Pairwise.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollisionbroadphase
+  *
+  * A broad phase that keeps the collision objects in a dynamic bounding volume tree of axis-aligned bounding boxes.
+  *
+  * Unlike a uniform grid, the tree adapts to the sizes of the collision objects,
+  * and handles worlds that mix very large and very small collision objects well.
+  * Collision objects are identified by their ids, which must be unique among the kept objects.
+  *
+  * '''Method'''
+  *
+  * Every collision object is a leaf in a binary tree, where each node has a bounding box
+  * that contains the bounding boxes of its children.
+  * The bounding box of a leaf is the bounding box of the transformed convex hull of the collision object
+  * (see CollisionInfo::gBoundingBox), fattened by a margin.
+  * When a collision object moves, its leaf is only reinserted if the new bounding box is no longer
+  * contained in the fattened box. Objects that move a little therefore cost almost nothing.
+  *
+  * Leaves are inserted at the sibling that increases the total perimeter of the tree the least,
+  * and the tree is rebalanced by rotations on the way back up after every insertion and removal,
+  * such that the height of the tree stays logarithmic.
+  *
+  * Pairs are found by querying the tree with the fattened box of every leaf,
+  * and region queries descend only into the nodes whose bounding boxes overlap the region.
+  * Reported pairs and query results are checked against the actual bounding boxes, not the fattened ones.
+  */
+class DynamicTreeBroadPhase {
+
+private:
+
+	/** An axis-aligned box which, unlike BoundingBox, can be assigned to. */
+	struct Box {
+		double minX;
+		double minY;
+		double maxX;
+		double maxY;
+
+		const bool intersects(const Box & that) const {
+			return minX <= that.maxX && that.minX <= maxX && minY <= that.maxY && that.minY <= maxY;
+		}
+
+		const bool contains(const Box & that) const {
+			return minX <= that.minX && minY <= that.minY && that.maxX <= maxX && that.maxY <= maxY;
+		}
+
+		const double perimeter() const {
+			return 2.0 * ((maxX - minX) + (maxY - minY));
+		}
+
+		static const Box combine(const Box & a, const Box & b) {
+			const Box result = { std::min(a.minX, b.minX), std::min(a.minY, b.minY),
+					std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY) };
+			return result;
+		}
+	};
+
+	/** A node of the tree. Leaves have a collision object, internal nodes have two children. */
+	struct Node {
+		Box box;
+		Box tightBox;
+		int parent; //NOTE: Also used as the next free node when the node is free.
+		int child1;
+		int child2;
+		int height; //NOTE: 0 for leaves, -1 for free nodes.
+		std::shared_ptr<const CollisionInfo> collInfo;
+
+		const bool isLeaf() const {
+			return child1 == nullNode;
+		}
+	};
+
+	static const int nullNode = -1;
+
+	const double margin;
+
+	std::vector<Node> nodes;
+	int root;
+	int freeList;
+	std::unordered_map<int, int> leafOfId;
+
+	const int allocateNode();
+
+	void freeNode(const int node);
+
+	void insertLeaf(const int leaf);
+
+	void removeLeaf(const int leaf);
+
+	const int balance(const int iA);
+
+	static const Box boxOf(const std::shared_ptr<const CollisionInfo> collInfo);
+
+	template <class F>
+	void query(const Box & box, const F & leafFunction) const {
+
+		if (root == nullNode) {
+			return;
+		}
+
+		std::vector<int> stack;
+		stack.push_back(root);
+
+		while (!stack.empty()) {
+
+			const auto index = stack.back();
+			stack.pop_back();
+
+			const auto & node = nodes[index];
+
+			if (node.box.intersects(box)) {
+				if (node.isLeaf()) {
+					leafFunction(index);
+				}
+				else {
+					stack.push_back(node.child1);
+					stack.push_back(node.child2);
+				}
+			}
+		}
+	}
+
+public:
+
+	/** @param aMargin non-negative margin the bounding boxes of the leaves are fattened by
+	  */
+	DynamicTreeBroadPhase(const double aMargin);
+
+	  /** Add a collision object, or move it if an object with the same id is already kept.
+	    *
+	    * @param collInfo the collision object
+	    * @return whether the leaf of the object was (re)inserted into the tree
+	    */
+	const bool setObject(const std::shared_ptr<const CollisionInfo> collInfo);
+
+	  /** Remove the collision object with the given id, if kept.
+	    *
+	    * @param id the id of the collision object
+	    */
+	void removeObject(const int id);
+
+	  /** @return the height of the tree, where an empty tree or a tree of a single leaf has height 0
+	    */
+	const int height() const;
+
+	  /** Find the pairs of kept collision objects whose bounding boxes overlap.
+	    *
+	    * @return the deduplicated pairs of collision objects that may collide
+	    */
+	const std::shared_ptr<const CollisionPairSet> findCandidatePairs() const;
+
+	  /** Find the kept collision objects whose bounding boxes overlap the given region.
+	    *
+	    * @param region an axis-aligned region
+	    * @return the collision objects that may be in the region
+	    */
+	const std::shared_ptr<const std::vector<std::shared_ptr<const CollisionInfo>>> queryRegion(
+			const BoundingBox & region) const;
+
+	  /** Find the pairs of kept collision objects that collide according to the given pairwise collision detection.
+	    *
+	    * @param pairwise the pairwise collision detection to test the candidate pairs with
+	    * @return the pairs of collision objects that collide
+	    */
+	const std::shared_ptr<const CollisionPairSet> findCollisions(const Pairwise & pairwise) const;
+
+	  /** Find the kept collision objects that collide with the given collision object
+	    * according to the given pairwise collision detection.
+	    *
+	    * The given collision object does not need to be kept, and a kept object with the same id is never reported.
+	    *
+	    * @param collInfo the collision object to test against
+	    * @param pairwise the pairwise collision detection to test the candidates with
+	    * @return the kept collision objects that collide with the given collision object
+	    */
+	const std::shared_ptr<const std::vector<std::shared_ptr<const CollisionInfo>>> findCollisionsWith(
+			const std::shared_ptr<const CollisionInfo> collInfo, const Pairwise & pairwise) const;
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_BROADPHASE_DYNAMICTREEBROADPHASE_HPP_ */
@@ -0,0 +1,158 @@
+/* SpatialHashBroadPhase.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <unordered_map>
+
+#include "SpatialHashBroadPhase.hpp"
+
+namespace poxelcoll {
+
+SpatialHashBroadPhase::SpatialHashBroadPhase(const double aCellSize) :
+		cellSize(aCellSize) {
+
+	if (!(aCellSize > 0.0)) {
+		std::cerr << "The cell size must be strictly positive." << std::endl;
+		throw 1;
+	}
+}
+
+const double SpatialHashBroadPhase::gCellSize() const {
+	return cellSize;
+}
+
+const std::shared_ptr<const CollisionPairSet> SpatialHashBroadPhase::findCandidatePairs(
+		const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) const {
+
+	const auto size = collInfos.size();
+
+	const auto cellOf = [this](const double a) {
+		return floor(a / cellSize);
+	};
+	const auto key = [](const int cellX, const int cellY) {
+		return (((unsigned long long) (unsigned int) cellX) << 32) | (unsigned long long) (unsigned int) cellY;
+	};
+
+	//Find the bounding boxes and the cells they span.
+	//The cells are found as doubles first, so objects spanning too many cells, or cells out of range, are found before any cast.
+
+	const auto cellLimit = (double) (1 << 30);
+
+	std::vector<IP> minCells;
+	std::vector<IP> maxCells;
+	std::vector<unsigned int> largeIndices;
+	minCells.reserve(size);
+	maxCells.reserve(size);
+
+	for (unsigned int i = 0; i < size; i++) {
+
+		const auto & box = (*collInfos[i]).gBoundingBox();
+
+		const auto minCellX = cellOf(box.pMin.gX());
+		const auto minCellY = cellOf(box.pMin.gY());
+		const auto maxCellX = cellOf(box.pMax.gX());
+		const auto maxCellY = cellOf(box.pMax.gY());
+
+		const auto inRange = fabs(minCellX) < cellLimit && fabs(minCellY) < cellLimit
+				&& fabs(maxCellX) < cellLimit && fabs(maxCellY) < cellLimit;
+
+		if (!inRange || (maxCellX - minCellX + 1.0) * (maxCellY - minCellY + 1.0) > maxCellsPerObject) {
+			largeIndices.push_back(i);
+			minCells.push_back(IP(0, 0));
+			maxCells.push_back(IP(-1, -1)); //No cells.
+		}
+		else {
+			minCells.push_back(IP((int) minCellX, (int) minCellY));
+			maxCells.push_back(IP((int) maxCellX, (int) maxCellY));
+		}
+	}
+
+	auto result = new CollisionPairSet();
+
+	const auto testPair = [&collInfos, result](const unsigned int i, const unsigned int j) {
+
+		if ((*collInfos[i]).gBoundingBox().intersects((*collInfos[j]).gBoundingBox())) {
+
+			const std::unique_ptr<const CollisionPair> pairNull(
+					CollisionPair::createNull((*collInfos[i]).gId(), (*collInfos[j]).gId())); //NOTE: Handle null.
+
+			if (pairNull.get() != 0) { //NOTE: Null means same id, which is not a pair.
+				result->insert(*pairNull);
+			}
+		}
+	};
+
+	//Test the large objects against every other object. A pair of large objects is only tested from the first of them.
+
+	for (unsigned int a = 0; a < largeIndices.size(); a++) {
+
+		const auto i = largeIndices[a];
+
+		for (unsigned int j = 0; j < size; j++) {
+
+			const auto jIsLarge = maxCells[j].gX() < minCells[j].gX();
+
+			if (j != i && (!jIsLarge || j > i)) {
+				testPair(i, j);
+			}
+		}
+	}
+
+	//Bucket the other objects.
+
+	std::unordered_map<unsigned long long, std::vector<unsigned int>> grid;
+
+	for (unsigned int i = 0; i < size; i++) {
+		for (auto cellX = minCells[i].gX(); cellX <= maxCells[i].gX(); cellX++) {
+			for (auto cellY = minCells[i].gY(); cellY <= maxCells[i].gY(); cellY++) {
+				grid[key(cellX, cellY)].push_back(i);
+			}
+		}
+	}
+
+	//Test the objects sharing a cell. Each pair is only reported by the first cell both of them are in.
+
+	for (auto cell = grid.begin(); cell != grid.end(); cell++) {
+
+		const auto & indices = (*cell).second;
+		const auto indicesSize = indices.size();
+
+		for (unsigned int a = 0; a < indicesSize; a++) {
+
+			const auto i = indices[a];
+
+			for (unsigned int b = a + 1; b < indicesSize; b++) {
+
+				const auto j = indices[b];
+
+				const auto firstSharedCellX = std::max(minCells[i].gX(), minCells[j].gX());
+				const auto firstSharedCellY = std::max(minCells[i].gY(), minCells[j].gY());
+
+				if (key(firstSharedCellX, firstSharedCellY) == (*cell).first) {
+					testPair(i, j);
+				}
+			}
+		}
+	}
+
+	return std::shared_ptr<const CollisionPairSet>(result);
+}
+
+}
@@ -0,0 +1,80 @@
+/* SpatialHashBroadPhase.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_BROADPHASE_SPATIALHASHBROADPHASE_HPP_
+#define POXELCOLL_COLLISION_BROADPHASE_SPATIALHASHBROADPHASE_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "BroadPhase.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollisionbroadphase
+  *
+  * A broad phase that buckets the bounding boxes of the collision objects into a uniform hash grid.
+  *
+  * '''Method'''
+  *
+  * For each collision object, the bounding box of its transformed convex hull is taken
+  * from its collision info, see CollisionInfo::gBoundingBox.
+  * Each bounding box is inserted into every grid cell it overlaps.
+  * The grid is unbounded and sparse, since the cells are kept in a hash map keyed by the cell coordinates.
+  * For each cell, the collision objects in it are tested pairwise by their bounding boxes.
+  * A pair is only reported by the one cell that contains the minimum corner of the overlap of the two bounding boxes,
+  * so pairs that share several cells are only tested and reported once.
+  *
+  * Objects whose bounding box spans more than maxCellsPerObject cells, or whose cells cannot be numbered
+  * (such as for huge boxes or a tiny cell size), are not inserted into the grid. They are kept on a separate list
+  * of large objects, and each is tested by its bounding box against every other collision object.
+  *
+  * '''Cell size'''
+  *
+  * The cell size should be around the size of the typical collision object.
+  * If it is much smaller, many objects end up on the list of large objects, which are tested against everything.
+  * If it is much larger, many objects share a cell, and the method degrades towards testing all pairs.
+  * Worlds that mix very large and very small objects are generally not handled well by a uniform grid.
+  */
+class SpatialHashBroadPhase : public virtual BroadPhase {
+
+private:
+
+	const double cellSize;
+
+public:
+
+	/** The largest number of cells an object is inserted into. Objects spanning more are tested against everything. */
+	static const unsigned int maxCellsPerObject = 64;
+
+	/** @param aCellSize strictly positive side-length of the grid cells
+	  */
+	SpatialHashBroadPhase(const double aCellSize);
+
+	const double gCellSize() const;
+
+	const std::shared_ptr<const CollisionPairSet> findCandidatePairs(
+			const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) const;
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_BROADPHASE_SPATIALHASHBROADPHASE_HPP_ */
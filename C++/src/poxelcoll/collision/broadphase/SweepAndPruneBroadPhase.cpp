@@ -0,0 +1,244 @@
+/* SweepAndPruneBroadPhase.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <unordered_set>
+
+#include "SweepAndPruneBroadPhase.hpp"
+
+namespace poxelcoll {
+
+SweepAndPruneBroadPhase::SweepAndPruneBroadPhase() {
+}
+
+const bool SweepAndPruneBroadPhase::slotsOverlap(const unsigned int slot1, const unsigned int slot2) const {
+
+	const auto & s1 = slots[slot1];
+	const auto & s2 = slots[slot2];
+
+	return s1.minX <= s2.maxX && s2.minX <= s1.maxX
+			&& s1.minY <= s2.maxY && s2.minY <= s1.maxY;
+}
+
+void SweepAndPruneBroadPhase::addPair(const unsigned int slot1, const unsigned int slot2) {
+
+	const std::unique_ptr<const CollisionPair> pairNull(
+			CollisionPair::createNull(slots[slot1].id, slots[slot2].id)); //NOTE: Handle null.
+
+	if (pairNull.get() != 0 && pairs.insert(*pairNull).second) {
+		//A pair that was removed and added again since the last sweep is not a change.
+		if (pendingRemoved.erase(*pairNull) == 0) {
+			pendingAdded.insert(*pairNull);
+		}
+	}
+}
+
+void SweepAndPruneBroadPhase::removePair(const unsigned int slot1, const unsigned int slot2) {
+
+	const std::unique_ptr<const CollisionPair> pairNull(
+			CollisionPair::createNull(slots[slot1].id, slots[slot2].id)); //NOTE: Handle null.
+
+	if (pairNull.get() != 0 && pairs.erase(*pairNull) != 0) {
+		//A pair that was added and removed again since the last sweep is not a change.
+		if (pendingAdded.erase(*pairNull) == 0) {
+			pendingRemoved.insert(*pairNull);
+		}
+	}
+}
+
+void SweepAndPruneBroadPhase::refreshAndSort(std::vector<Endpoint> & endpoints, const bool xAxis) {
+
+	const auto size = endpoints.size();
+
+	for (unsigned int i = 0; i < size; i++) {
+		auto & endpoint = endpoints[i];
+		const auto & slot = slots[endpoint.slot];
+		if (xAxis) {
+			endpoint.value = endpoint.isMax ? slot.maxX : slot.minX;
+		}
+		else {
+			endpoint.value = endpoint.isMax ? slot.maxY : slot.minY;
+		}
+	}
+
+	//NOTE: At equal values, minimums go before maximums, such that touching boxes overlap.
+	const auto less = [](const Endpoint & a, const Endpoint & b) {
+		return a.value < b.value || (a.value == b.value && !a.isMax && b.isMax);
+	};
+
+	//Insertion sort. Every swap is between two end points that have changed order since the last sweep.
+	for (unsigned int i = 1; i < size; i++) {
+
+		const auto current = endpoints[i];
+		auto j = i;
+
+		while (j > 0 && less(current, endpoints[j - 1])) {
+
+			const auto previous = endpoints[j - 1];
+
+			if (!current.isMax && previous.isMax) {
+				//A minimum passed a maximum, so the boxes may have started to overlap.
+				if (slotsOverlap(current.slot, previous.slot)) {
+					addPair(current.slot, previous.slot);
+				}
+			}
+			else if (current.isMax && !previous.isMax) {
+				//A maximum passed a minimum, so the boxes have stopped overlapping.
+				removePair(current.slot, previous.slot);
+			}
+
+			endpoints[j] = previous;
+			j--;
+		}
+
+		endpoints[j] = current;
+	}
+}
+
+void SweepAndPruneBroadPhase::setObject(const std::shared_ptr<const CollisionInfo> collInfo) {
+
+	const auto & box = (*collInfo).gBoundingBox();
+
+	const auto id = (*collInfo).gId();
+	const auto found = slotOfId.find(id);
+
+	unsigned int slotIndex;
+
+	if (found != slotOfId.end()) {
+		slotIndex = (*found).second;
+	}
+	else {
+
+		if (freeSlots.empty()) {
+			slotIndex = slots.size();
+			slots.push_back(Slot());
+		}
+		else {
+			slotIndex = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		slotOfId[id] = slotIndex;
+
+		//The end points start out at the end of the arrays, as if the object was infinitely far away.
+		const Endpoint minEndpoint = { HUGE_VAL, slotIndex, false };
+		const Endpoint maxEndpoint = { HUGE_VAL, slotIndex, true };
+		endpointsX.push_back(minEndpoint);
+		endpointsX.push_back(maxEndpoint);
+		endpointsY.push_back(minEndpoint);
+		endpointsY.push_back(maxEndpoint);
+	}
+
+	auto & slot = slots[slotIndex];
+	slot.id = id;
+	slot.alive = true;
+	slot.minX = box.pMin.gX();
+	slot.minY = box.pMin.gY();
+	slot.maxX = box.pMax.gX();
+	slot.maxY = box.pMax.gY();
+}
+
+void SweepAndPruneBroadPhase::removeObject(const int id) {
+
+	const auto found = slotOfId.find(id);
+
+	if (found != slotOfId.end()) {
+
+		const auto slotIndex = (*found).second;
+
+		std::vector<unsigned int> partners;
+		for (auto i = pairs.begin(); i != pairs.end(); i++) {
+			if ((*i).id1 == id) {
+				partners.push_back(slotOfId[(*i).id2]);
+			}
+			else if ((*i).id2 == id) {
+				partners.push_back(slotOfId[(*i).id1]);
+			}
+		}
+		for (auto i = partners.begin(); i != partners.end(); i++) {
+			removePair(slotIndex, *i);
+		}
+
+		//NOTE: The slot is first reused after the next sweep has removed its end points.
+		slots[slotIndex].alive = false;
+		slotsToFree.push_back(slotIndex);
+		slotOfId.erase(found);
+	}
+}
+
+const CollisionPairChanges SweepAndPruneBroadPhase::sweep() {
+
+	if (!slotsToFree.empty()) {
+
+		const auto isDead = [this](const Endpoint & endpoint) {
+			return !slots[endpoint.slot].alive;
+		};
+		endpointsX.erase(std::remove_if(endpointsX.begin(), endpointsX.end(), isDead), endpointsX.end());
+		endpointsY.erase(std::remove_if(endpointsY.begin(), endpointsY.end(), isDead), endpointsY.end());
+
+		freeSlots.insert(freeSlots.end(), slotsToFree.begin(), slotsToFree.end());
+		slotsToFree.clear();
+	}
+
+	refreshAndSort(endpointsX, true);
+	refreshAndSort(endpointsY, false);
+
+	const auto added = std::shared_ptr<const CollisionPairSet>(new CollisionPairSet(pendingAdded));
+	const auto removed = std::shared_ptr<const CollisionPairSet>(new CollisionPairSet(pendingRemoved));
+
+	pendingAdded.clear();
+	pendingRemoved.clear();
+
+	return CollisionPairChanges(added, removed);
+}
+
+const CollisionPairChanges SweepAndPruneBroadPhase::update(
+		const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) {
+
+	std::unordered_set<int> givenIds;
+
+	for (auto i = collInfos.begin(); i != collInfos.end(); i++) {
+		if (!givenIds.insert((**i).gId()).second) {
+			std::cerr << "The ids of the given collision objects must be unique." << std::endl;
+			throw 1;
+		}
+	}
+
+	std::vector<int> idsToRemove;
+	for (auto i = slotOfId.begin(); i != slotOfId.end(); i++) {
+		if (givenIds.count((*i).first) == 0) {
+			idsToRemove.push_back((*i).first);
+		}
+	}
+	for (auto i = idsToRemove.begin(); i != idsToRemove.end(); i++) {
+		removeObject(*i);
+	}
+
+	for (auto i = collInfos.begin(); i != collInfos.end(); i++) {
+		setObject(*i);
+	}
+
+	return sweep();
+}
+
+const std::shared_ptr<const CollisionPairSet> SweepAndPruneBroadPhase::currentPairs() const {
+	return std::shared_ptr<const CollisionPairSet>(new CollisionPairSet(pairs));
+}
+
+}
@@ -0,0 +1,147 @@
+/* SweepAndPruneBroadPhase.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_BROADPHASE_SWEEPANDPRUNEBROADPHASE_HPP_
+#define POXELCOLL_COLLISION_BROADPHASE_SWEEPANDPRUNEBROADPHASE_HPP_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "BroadPhase.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollisionbroadphase
+  *
+  * An incremental sort-and-sweep broad phase that exploits temporal coherence.
+  *
+  * The broad phase keeps the collision objects between calls, and reports the changes
+  * to the set of overlapping pairs instead of the full set.
+  * Collision objects are identified by their ids, which must be unique among the kept objects.
+  *
+  * '''Method'''
+  *
+  * The bounding box of each collision object is the bounding box of its transformed convex hull,
+  * see CollisionInfo::gBoundingBox.
+  * For each axis, the end points of all the bounding boxes are kept in an array, which is sorted by the end point values.
+  * When the objects move, the arrays are re-sorted by insertion sort.
+  * Since objects generally only move a little between frames, the arrays are nearly sorted,
+  * and re-sorting takes time linear in the number of objects plus the number of swaps.
+  * Whenever the minimum of one box is swapped past the maximum of another box,
+  * the two boxes may have started to overlap, and the pair is added if the boxes intersect.
+  * Whenever the maximum of one box is swapped past the minimum of another box,
+  * the two boxes have stopped overlapping, and the pair is removed.
+  * Thus the work done per sweep mostly depends on how much the scene changes,
+  * not on the number of objects.
+  *
+  * New objects start out (virtually) infinitely far away, and are sorted into place like moving objects.
+  * Removed objects have their pairs removed directly.
+  *
+  * '''Usage'''
+  *
+  * Either call update with all collision objects once per frame,
+  * or call setObject for the objects that were added or moved, removeObject for those that were removed,
+  * and then sweep.
+  */
+class SweepAndPruneBroadPhase {
+
+private:
+
+	/** An end point of a bounding box along one axis. */
+	struct Endpoint {
+		double value;
+		unsigned int slot;
+		bool isMax;
+	};
+
+	/** A kept collision object. */
+	struct Slot {
+		int id;
+		bool alive;
+		double minX;
+		double minY;
+		double maxX;
+		double maxY;
+	};
+
+	std::vector<Endpoint> endpointsX;
+	std::vector<Endpoint> endpointsY;
+	std::vector<Slot> slots;
+	std::vector<unsigned int> freeSlots;
+	std::vector<unsigned int> slotsToFree;
+	std::unordered_map<int, unsigned int> slotOfId;
+
+	CollisionPairSet pairs;
+	CollisionPairSet pendingAdded;
+	CollisionPairSet pendingRemoved;
+
+	const bool slotsOverlap(const unsigned int slot1, const unsigned int slot2) const;
+
+	void addPair(const unsigned int slot1, const unsigned int slot2);
+
+	void removePair(const unsigned int slot1, const unsigned int slot2);
+
+	void refreshAndSort(std::vector<Endpoint> & endpoints, const bool xAxis);
+
+public:
+
+	SweepAndPruneBroadPhase();
+
+	  /** Add a collision object, or move it if an object with the same id is already kept.
+	    *
+	    * The change is not reflected in the pairs until the next sweep.
+	    *
+	    * @param collInfo the collision object
+	    */
+	void setObject(const std::shared_ptr<const CollisionInfo> collInfo);
+
+	  /** Remove the collision object with the given id, if kept.
+	    *
+	    * The pairs with the object are removed at once, and reported by the next sweep.
+	    *
+	    * @param id the id of the collision object
+	    */
+	void removeObject(const int id);
+
+	  /** Re-sort the end points, and find the changes to the overlapping pairs since the last sweep.
+	    *
+	    * @return the pairs that were added and removed since the last sweep
+	    */
+	const CollisionPairChanges sweep();
+
+	  /** Replace the kept collision objects with the given collision objects and sweep.
+	    *
+	    * Objects that are kept but not given are removed.
+	    *
+	    * @param collInfos the collision objects of this frame, with unique ids
+	    * @return the pairs that were added and removed since the last sweep
+	    */
+	const CollisionPairChanges update(const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos);
+
+	  /** @return the pairs that overlapped as of the last sweep
+	    */
+	const std::shared_ptr<const CollisionPairSet> currentPairs() const;
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_BROADPHASE_SWEEPANDPRUNEBROADPHASE_HPP_ */
@@ -0,0 +1,44 @@
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \defgroup poxelcollcollisionbroadphase poxelcoll_collision_broadphase
+  * \ingroup poxelcollcollision
+  * 
+  * The broad phase collision detection finds the pairs of collision objects that may collide.
+  *
+  * The broad phase works on whole worlds of collision objects, and filters out the pairs
+  * that obviously do not collide (ie. small objects that are far away from each other)
+  * by comparing over-approximating axis-aligned bounding boxes.
+  * The remaining pairs are given as collision pairs,
+  * which can then be tested by a pairwise collision detection.
+  *
+  * '''Current status and improvements'''
+  *
+  * The spatial hash broad phase buckets the bounding boxes into a uniform grid.
+  * It is simple and efficient as long as the collision objects are of roughly the same size,
+  * but it has to be tuned through its cell size.
+  *
+  * The sweep and prune broad phase keeps sorted bounding box end points between frames,
+  * and reports the changes to the overlapping pairs. It is efficient when the objects
+  * move little from frame to frame, which is generally the case.
+  *
+  * The dynamic tree broad phase keeps the bounding boxes in a balanced bounding volume tree.
+  * It needs no tuning for the sizes of the objects, handles worlds that mix large and small objects,
+  * and supports region queries. It can also test the found pairs with a pairwise collision detection directly.
+  */
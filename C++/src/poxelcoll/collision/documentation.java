@@ -20,7 +20,7 @@
 /** \defgroup poxelcollcollision poxelcoll_collision
   * \ingroup poxelcoll
   * 
-  * The library supports the narrow phase of collision detection.
+  * The library supports the narrow phase of collision detection, as well as a simple broad phase.
   *
   * The narrow phase of collision detection is defined as the parts
   * of collision detection that deals with detecting collisions between
@@ -28,8 +28,9 @@
   * which seeks to decrease the number of potential collisions between many objects
   * by efficiently filtering out objects that obviously do not collide
   * (ie. small objects that are far away from each other).
-  * While this library as of version 0.1 offers no support for broad phase collision
-  * detection, there exists other libraries that handles this task,
+  * The library offers basic support for broad phase collision detection in the broad phase package,
+  * which finds the collision pairs that are then given to the narrow phase.
+  * There also exists other libraries that handles this task,
   * and which potentially can be used with this library.
   *
   * The narrow phase of collision detection generally consists of parts that quickly
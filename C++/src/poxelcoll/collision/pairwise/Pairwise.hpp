@@ -22,6 +22,13 @@
 #ifndef POXELCOLL_COLLISION_PAIRWISE_PAIRWISE_HPP_
 #define POXELCOLL_COLLISION_PAIRWISE_PAIRWISE_HPP_
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "../../DataTypes.hpp"
 #include "../../CollisionInfo.hpp"
 
 namespace poxelcoll {
@@ -40,6 +47,15 @@ class Pairwise {
 public:
 	virtual ~Pairwise(){
 
+	}
+
+	  /** Declares that a new frame begins, such that the work kept for the collision objects of the previous frame can be forgotten.
+	    *
+	    * Implementations that keep work per collision object between calls keep it until the next call of this,
+	    * so it should be called once per frame, before the collision objects of the frame are tested.
+	    * The default implementation keeps nothing, and does nothing.
+	    */
+	virtual void beginFrame() const {
 	}
 
 	  /** Given two collision objects, determine whether there is a collision between them.
@@ -54,6 +70,44 @@ public:
 			const std::shared_ptr<const CollisionInfo> collInfo1,
 			const std::shared_ptr<const CollisionInfo> collInfo2) const = 0;
 
+	  /** Given a sequence of collision pairs and the collision objects they refer to, determine for each pair whether there is a collision.
+	    *
+	    * The default implementation tests each pair on its own. Implementations may override it
+	    * to share the work that is done per collision object between the pairs the object takes part in.
+	    *
+	    * @param pairs the pairs to test, referring to the ids of the collision objects
+	    * @param collInfos the collision objects, which must include every object referred to by the pairs
+	    * @return a bitset with one bit per pair, in the order of the pairs, which is set if the pair collides
+	    */
+	virtual const boost::dynamic_bitset<> testForCollisions(
+			const std::vector<CollisionPair> & pairs,
+			const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) const {
+
+		std::unordered_map<int, std::shared_ptr<const CollisionInfo>> collInfoOfId;
+		for (auto i = collInfos.begin(); i != collInfos.end(); i++) {
+			collInfoOfId[(**i).gId()] = *i;
+		}
+
+		const auto findCollInfo = [&collInfoOfId](const int id) {
+			const auto found = collInfoOfId.find(id);
+			if (found == collInfoOfId.end()) {
+				std::cerr << "A pair referred to a collision object that was not given." << std::endl;
+				throw 1;
+			}
+			return (*found).second;
+		};
+
+		boost::dynamic_bitset<> result(pairs.size());
+
+		for (unsigned int i = 0; i < pairs.size(); i++) {
+			if (testForCollision(findCollInfo(pairs[i].id1), findCollInfo(pairs[i].id2))) {
+				result[i] = 1;
+			}
+		}
+
+		return result;
+	}
+
 };
 
 }
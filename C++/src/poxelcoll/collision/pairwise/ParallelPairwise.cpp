@@ -0,0 +1,191 @@
+/* ParallelPairwise.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+
+#include "ParallelPairwise.hpp"
+
+namespace poxelcoll {
+
+ParallelPairwise::ParallelPairwise(const std::shared_ptr<const Pairwise> aPairwise, const unsigned int threadCount) :
+		pairwise(aPairwise), threadPool(new WorkStealingThreadPool(threadCount)) {
+
+	if (aPairwise.get() == 0) {
+		std::cerr << "The pairwise collision detection must be given." << std::endl;
+		throw 1;
+	}
+}
+
+const unsigned int ParallelPairwise::gThreadCount() const {
+	return (*threadPool).gThreadCount();
+}
+
+void ParallelPairwise::beginFrame() const {
+	(*pairwise).beginFrame();
+}
+
+const bool ParallelPairwise::testForCollision(
+		const std::shared_ptr<const CollisionInfo> collInfo1,
+		const std::shared_ptr<const CollisionInfo> collInfo2) const {
+
+	return (*pairwise).testForCollision(collInfo1, collInfo2);
+}
+
+const boost::dynamic_bitset<> ParallelPairwise::testForCollisions(
+		const std::vector<CollisionPair> & pairs,
+		const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) const {
+
+	//Find the collision objects of the pairs, and the bounding box of each object once.
+
+	std::unordered_map<int, unsigned int> indexOfId;
+	for (unsigned int i = 0; i < collInfos.size(); i++) {
+		indexOfId[(*collInfos[i]).gId()] = i;
+	}
+
+	const auto findIndex = [&indexOfId](const int id) {
+		const auto found = indexOfId.find(id);
+		if (found == indexOfId.end()) {
+			std::cerr << "A pair referred to a collision object that was not given." << std::endl;
+			throw 1;
+		}
+		return (*found).second;
+	};
+
+	const auto size = pairs.size();
+
+	std::vector<unsigned int> firstIndices;
+	std::vector<unsigned int> secondIndices;
+	firstIndices.reserve(size);
+	secondIndices.reserve(size);
+
+	//Estimate the cost of each pair, and split them into expensive and cheap ones.
+	//Pairs whose bounding boxes do not overlap are not tested at all.
+
+	std::vector<std::pair<double, unsigned int>> expensivePairs; //Estimated cost and position.
+	std::vector<unsigned int> cheapPairs;
+
+	for (unsigned int i = 0; i < size; i++) {
+
+		const auto index1 = findIndex(pairs[i].id1);
+		const auto index2 = findIndex(pairs[i].id2);
+		firstIndices.push_back(index1);
+		secondIndices.push_back(index2);
+
+		const auto & box1 = (*collInfos[index1]).gBoundingBox();
+		const auto & box2 = (*collInfos[index2]).gBoundingBox();
+
+		const auto overlapWidth = std::min(box1.pMax.gX(), box2.pMax.gX()) - std::max(box1.pMin.gX(), box2.pMin.gX());
+		const auto overlapHeight = std::min(box1.pMax.gY(), box2.pMax.gY()) - std::max(box1.pMin.gY(), box2.pMin.gY());
+
+		const auto bothFull = (*(*collInfos[index1]).gMask()).isPolygonFull() && (*(*collInfos[index2]).gMask()).isPolygonFull();
+
+		if (!box1.intersects(box2)) {
+			//The bounding boxes of the transformed convex hulls over-approximate the objects, so there is no collision, and nothing to test.
+		}
+		else if (!bothFull && overlapWidth > 0.0 && overlapHeight > 0.0 && overlapWidth * overlapHeight >= expensiveOverlapArea) {
+			expensivePairs.push_back(std::make_pair(overlapWidth * overlapHeight, i));
+		}
+		else {
+			cheapPairs.push_back(i);
+		}
+	}
+
+	//The expensive pairs are started first, most expensive first.
+	//Ties are broken by position, so the division of work does not depend on the sorting implementation.
+
+	std::sort(expensivePairs.begin(), expensivePairs.end(),
+		[](const std::pair<double, unsigned int> & a, const std::pair<double, unsigned int> & b) {
+			return a.first > b.first || (a.first == b.first && a.second < b.second);
+		}
+	);
+
+	//Each pair has its own result slot, which is only written by the task testing it.
+	//The slots are bytes and not bits, since bits in the same word cannot be written from different threads.
+
+	std::vector<unsigned char> results(size, 0);
+
+	//A task hands its pairs to the wrapped pairwise as one batch, so the work per collision object is shared within the task.
+
+	const auto testRange = [this, &pairs, &collInfos, &firstIndices, &secondIndices, &results](
+			const unsigned int * const begin, const unsigned int * const end) {
+
+		std::vector<CollisionPair> taskPairs;
+		std::vector<unsigned int> taskIndices;
+		for (auto i = begin; i != end; i++) {
+			taskPairs.push_back(pairs[*i]);
+			taskIndices.push_back(firstIndices[*i]);
+			taskIndices.push_back(secondIndices[*i]);
+		}
+		std::sort(taskIndices.begin(), taskIndices.end());
+		taskIndices.erase(std::unique(taskIndices.begin(), taskIndices.end()), taskIndices.end());
+
+		std::vector<std::shared_ptr<const CollisionInfo>> taskCollInfos;
+		for (auto i = taskIndices.begin(); i != taskIndices.end(); i++) {
+			taskCollInfos.push_back(collInfos[*i]);
+		}
+
+		const auto taskResult = (*pairwise).testForCollisions(taskPairs, taskCollInfos);
+
+		for (auto i = begin; i != end; i++) {
+			if (taskResult[i - begin]) {
+				results[*i] = 1;
+			}
+		}
+	};
+
+	std::vector<unsigned int> expensivePositions;
+	expensivePositions.reserve(expensivePairs.size());
+	for (auto i = expensivePairs.begin(); i != expensivePairs.end(); i++) {
+		expensivePositions.push_back((*i).second);
+	}
+
+	std::vector<std::function<void()>> tasks;
+
+	for (unsigned int i = 0; i < expensivePositions.size(); i++) {
+		const auto position = expensivePositions.data() + i;
+		tasks.push_back([testRange, position]() {
+			testRange(position, position + 1);
+		});
+	}
+	for (unsigned int i = 0; i < cheapPairs.size(); i += cheapPairsPerTask) {
+		const auto begin = cheapPairs.data() + i;
+		const auto end = cheapPairs.data() + std::min((unsigned int) cheapPairs.size(), i + cheapPairsPerTask);
+		tasks.push_back([testRange, begin, end]() {
+			testRange(begin, end);
+		});
+	}
+
+	(*threadPool).runAll(tasks);
+
+	boost::dynamic_bitset<> result(size);
+	for (unsigned int i = 0; i < size; i++) {
+		if (results[i] != 0) {
+			result[i] = 1;
+		}
+	}
+
+	return result;
+}
+
+}
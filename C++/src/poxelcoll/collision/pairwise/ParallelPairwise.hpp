@@ -0,0 +1,108 @@
+/* ParallelPairwise.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_PAIRWISE_PARALLELPAIRWISE_HPP_
+#define POXELCOLL_COLLISION_PAIRWISE_PARALLELPAIRWISE_HPP_
+
+#include <memory>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "Pairwise.hpp"
+#include "WorkStealingThreadPool.hpp"
+#include "../../DataTypes.hpp"
+#include "../../CollisionInfo.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollisionpairwise
+  *
+  * A pairwise collision detection that tests batches of collision pairs on several threads,
+  * using another pairwise collision detection for the individual pairs.
+  *
+  * '''Method'''
+  *
+  * The cost of each pair is estimated from the overlap of the bounding boxes
+  * of the transformed convex hulls of its collision objects. Pairs whose boxes do not overlap cannot collide, and are not tested at all.
+  * Pairs with a small overlap, or where both masks are full polygons,
+  * are cheap, and are grouped into tasks of several pairs, which are given to the wrapped pairwise as one batch. Pairs with a large overlap where at least one mask
+  * has a binary image are expensive, and each is given a task of its own, so that idle threads can steal them.
+  * The tasks are run by a work-stealing thread pool, expensive first.
+  *
+  * Every pair writes its result to its own slot, so the result is the same as for the sequential test,
+  * in the same order, no matter how the work was divided between the threads.
+  *
+  * The wrapped pairwise collision detection must be safe to call from several threads at once,
+  * which is the case for the simple pixel-perfect pairwise collision detection.
+  */
+class ParallelPairwise : public virtual Pairwise {
+
+private:
+
+	const std::shared_ptr<const Pairwise> pairwise;
+	const std::shared_ptr<WorkStealingThreadPool> threadPool;
+
+public:
+
+	/** The number of cheap pairs that are tested in one task. */
+	static const unsigned int cheapPairsPerTask = 32;
+
+	/** The overlap area (in pixels) of the bounding boxes from which a pair with a binary image is expensive. */
+	static constexpr double expensiveOverlapArea = 256.0;
+
+	/** @param aPairwise the pairwise collision detection used for the individual pairs
+	  * @param threadCount the number of worker threads, or 0 for the number of hardware threads
+	  */
+	ParallelPairwise(const std::shared_ptr<const Pairwise> aPairwise, const unsigned int threadCount = 0);
+
+	const unsigned int gThreadCount() const;
+
+	/** Begins a new frame in the wrapped pairwise collision detection. */
+	void beginFrame() const;
+
+	  /** Given two collision objects, determine whether there is a collision between them.
+	    *
+	    * A single pair is tested on the calling thread.
+	    *
+	    * @param collInfo1 first collision object
+	    * @param collInfo2 second collision object
+	    * @return whether there is a collision or not between the two objects
+	    */
+	const bool testForCollision(
+			const std::shared_ptr<const CollisionInfo> collInfo1,
+			const std::shared_ptr<const CollisionInfo> collInfo2) const;
+
+	  /** Given a sequence of collision pairs and the collision objects they refer to, determine for each pair whether there is a collision,
+	    * dividing the pairs between the worker threads.
+	    *
+	    * @param pairs the pairs to test, referring to the ids of the collision objects
+	    * @param collInfos the collision objects, which must include every object referred to by the pairs
+	    * @return a bitset with one bit per pair, in the order of the pairs, which is set if the pair collides
+	    */
+	const boost::dynamic_bitset<> testForCollisions(
+			const std::vector<CollisionPair> & pairs,
+			const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) const;
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_PAIRWISE_PARALLELPAIRWISE_HPP_ */
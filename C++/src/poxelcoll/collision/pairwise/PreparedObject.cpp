@@ -0,0 +1,220 @@
+/* PreparedObject.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <utility>
+
+#include "PreparedObject.hpp"
+#include "../../geometry/matrix/Transformation.hpp"
+
+namespace poxelcoll {
+
+PreparedObject::PreparedObject(const std::shared_ptr<const CollisionInfo> aCollInfo,
+		const std::shared_ptr<const Mask> aMask,
+		const Affine aTransformation,
+		const Affine aInverse,
+		const std::shared_ptr<const ConvexCCWPolygon> aTransformedConvexHull,
+		const std::vector<std::shared_ptr<const ConvexCCWPolygon>> & aTransformedSubHulls,
+		const std::vector<std::shared_ptr<const BoundingBox>> & aSubHullBoundingBoxes,
+		std::vector<CompactHull> aCompactHulls) :
+		collInfo(aCollInfo), mask(aMask), transformation(aTransformation), invertible(aTransformation.hasInverse()),
+		inverse(aInverse),
+		transformedConvexHull(aTransformedConvexHull), compactHulls(std::move(aCompactHulls)), transformedSubHulls(aTransformedSubHulls),
+		subHullBoundingBoxes(aSubHullBoundingBoxes), kind(aTransformation.kind()),
+		integerTranslationOnly(kind == TransformKind::IntegerTranslationK && aMask == (*aCollInfo).gMask()),
+		bitsetImageNull(dynamic_cast<const BitsetBinaryImage*>((*aMask).binaryImageNull().get())) {
+}
+
+const std::vector<std::shared_ptr<const PreparedObject>> PreparedObject::prepareAll(
+		const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos, TransformArena<double> & arena) {
+
+	//The hulls of all the objects are gathered first, such that they are transformed in one pass.
+
+	arena.clear();
+
+	std::vector<Sampling> samplings;
+	samplings.reserve(collInfos.size());
+
+	for (auto i = collInfos.begin(); i != collInfos.end(); i++) {
+		samplings.push_back(samplingOf(*i, arena));
+	}
+
+	arena.transformAll();
+
+	std::vector<std::shared_ptr<const PreparedObject>> result;
+	result.reserve(collInfos.size());
+
+	for (unsigned int i = 0; i < collInfos.size(); i++) {
+		result.push_back(fromArena(collInfos[i], samplings[i], arena));
+	}
+
+	return result;
+}
+
+const PreparedObject::Sampling PreparedObject::samplingOf(const std::shared_ptr<const CollisionInfo> collInfo,
+		TransformArena<double> & arena) {
+
+	const auto position = (*collInfo).gPosition();
+	const auto ownMask = (*collInfo).gMask();
+
+	//A pre-rotated mask gives the same points as the rotated mask only at whole positions.
+
+	const auto rotatedMasksNull = (*ownMask).rotatedMasksNull();
+	const auto rotatedMaskNull = rotatedMasksNull.get() != 0 && !Transformation::isTranslationOnly(collInfo)
+			&& position.gX() == floor(position.gX()) && position.gY() == floor(position.gY()) ?
+			(*rotatedMasksNull).rotatedMaskNullOf((*collInfo).gAngle(), (*collInfo).gScaleX(), (*collInfo).gScaleY()) :
+			std::shared_ptr<const Mask>();
+
+	const auto mask = rotatedMaskNull.get() != 0 ? rotatedMaskNull : ownMask;
+
+	//The pre-rotated mask is only used for sampling the points. The hulls and the bounding boxes are always those of the own mask,
+	//such that the points that are tested, and so the answers, do not depend on whether a pre-rotated mask was at hand.
+
+	const auto ownTransformation = Transformation::getAffineTransformation(collInfo);
+
+	const auto transformation = rotatedMaskNull.get() != 0 ?
+			Transformation::getAffineTransformation((*mask).origin(), position, 0.0, 1.0, 1.0) :
+			ownTransformation;
+
+	//The inverses are found in closed form: the cached one of the collision info, or the translation back.
+
+	const auto inverse = rotatedMaskNull.get() != 0 ?
+			Transformation::getInverseAffineTransformationUnsafe((*mask).origin(), position, 0.0, 1.0, 1.0) :
+			(*collInfo).gInverseTransformation();
+
+	//Only an object with a well-defined inverse can collide, so only then are its hulls needed.
+
+	auto hullSet = 0u;
+	auto subHullSetsBegin = arena.setCount();
+
+	if (ownTransformation.hasInverse()) {
+
+		hullSet = addHull(*(*ownMask).convexHull(), ownTransformation, arena);
+
+		subHullSetsBegin = arena.setCount();
+
+		const auto subHullsNull = (*ownMask).subHullsNull();
+
+		if (subHullsNull.get() != 0) {
+			for (auto i = (*subHullsNull).begin(); i != (*subHullsNull).end(); i++) {
+				addHull(**i, ownTransformation, arena);
+			}
+		}
+	}
+
+	const Sampling sampling = { mask, transformation, inverse, ownTransformation, hullSet, subHullSetsBegin, arena.setCount() };
+	return sampling;
+}
+
+const std::shared_ptr<const PreparedObject> PreparedObject::fromArena(const std::shared_ptr<const CollisionInfo> collInfo,
+		const Sampling & sampling, const TransformArena<double> & arena) {
+
+	const auto & ownTransformation = sampling.ownTransformation;
+
+	if (!ownTransformation.hasInverse()) {
+		return std::shared_ptr<const PreparedObject>(new PreparedObject(collInfo, sampling.mask, ownTransformation, Affine::identity(),
+				std::shared_ptr<const ConvexCCWPolygon>(),
+				std::vector<std::shared_ptr<const ConvexCCWPolygon>>(), std::vector<std::shared_ptr<const BoundingBox>>(),
+				std::vector<CompactHull>()));
+	}
+	else {
+
+		const auto transformedConvexHull = assumingValidConvexPolygonPointsTransformToCCWEvenIfCW(pointsOf(arena, sampling.hullSet));
+
+		const auto hasSubHulls = sampling.subHullSetsBegin != sampling.subHullSetsEnd;
+
+		std::vector<CompactHull> compactHulls;
+		compactHulls.reserve(hasSubHulls ? sampling.subHullSetsEnd - sampling.subHullSetsBegin : 1);
+
+		auto compactHullsFit = true;
+
+		if (hasSubHulls) {
+			for (auto i = sampling.subHullSetsBegin; i != sampling.subHullSetsEnd && compactHullsFit; i++) {
+				compactHullsFit = addCompactHull(arena, i, ownTransformation, compactHulls);
+			}
+		}
+		else {
+			compactHullsFit = addCompactHull(arena, sampling.hullSet, ownTransformation, compactHulls);
+		}
+
+		//The shared sub-hulls are only needed if the compact hulls do not fit.
+
+		std::vector<std::shared_ptr<const ConvexCCWPolygon>> transformedSubHulls;
+		std::vector<std::shared_ptr<const BoundingBox>> subHullBoundingBoxes;
+
+		if (!compactHullsFit) {
+
+			compactHulls.clear();
+
+			for (auto i = sampling.subHullSetsBegin; i != sampling.subHullSetsEnd; i++) {
+				transformedSubHulls.push_back(assumingValidConvexPolygonPointsTransformToCCWEvenIfCW(pointsOf(arena, i)));
+				subHullBoundingBoxes.push_back(std::shared_ptr<const BoundingBox>(new BoundingBox(arena.boundingBox(i))));
+			}
+		}
+
+		return std::shared_ptr<const PreparedObject>(new PreparedObject(collInfo, sampling.mask, sampling.transformation, sampling.inverse,
+				transformedConvexHull, transformedSubHulls, subHullBoundingBoxes,
+				compactHulls));
+	}
+}
+
+const unsigned int PreparedObject::addHull(const ConvexCCWPolygon & hull, const Affine & transformation,
+		TransformArena<double> & arena) {
+
+	const auto points = hull.points();
+
+	return points.get() == 0 ? arena.add(0, 0, transformation) : arena.add((*points).data(), (*points).size(), transformation);
+}
+
+const std::shared_ptr<const std::vector<P>> PreparedObject::pointsOf(const TransformArena<double> & arena, const unsigned int set) {
+
+	const auto size = arena.size(set);
+
+	const auto result = new std::vector<P>();
+	result->reserve(size);
+
+	for (unsigned int i = 0; i < size; i++) {
+		result->push_back(arena.point(set, i));
+	}
+
+	return std::shared_ptr<const std::vector<P>>(result);
+}
+
+const bool PreparedObject::addCompactHull(const TransformArena<double> & arena, const unsigned int set, const Affine & transformation,
+		std::vector<CompactHull> & compactHulls) {
+
+	//The hull is written in place, since copying a compact hull copies all of its storage.
+	//An empty hull, which a mask never has, is left to the shared polygons.
+
+	if (arena.size(set) == 0) {
+		return false;
+	}
+
+	compactHulls.emplace_back();
+
+	if (!CompactHull::fromTransformedCoordinates(arena.xs(set), arena.ys(set), arena.size(set), transformation, compactHulls.back())) {
+		compactHulls.pop_back();
+		return false;
+	}
+
+	return true;
+}
+
+}
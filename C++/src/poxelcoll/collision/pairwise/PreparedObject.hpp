@@ -0,0 +1,245 @@
+/* PreparedObject.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_PAIRWISE_PREPAREDOBJECT_HPP_
+#define POXELCOLL_COLLISION_PAIRWISE_PREPAREDOBJECT_HPP_
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "../../DataTypes.hpp"
+#include "../../CollisionInfo.hpp"
+#include "../../binaryimage/BitsetBinaryImage.hpp"
+#include "../../geometry/convexccwpolygon/CompactConvexPolygon.hpp"
+#include "../../geometry/convexccwpolygon/ConvexClipper.hpp"
+#include "../../geometry/convexccwpolygon/DataTypes.hpp"
+#include "../../geometry/matrix/Affine.hpp"
+#include "../../geometry/matrix/TransformArena.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollisionpairwise
+  *
+  * The parts of the pairwise collision test that only depend on a single collision object.
+  *
+  * This is the affine transformation and its inverse, the transformed convex hull and sub-hulls of the mask,
+  * and the bounding boxes of the sub-hulls in world space. The bounding box of the hull is the one the collision info
+  * already keeps. Finding the rest involves trigonometry and allocation,
+  * so they are found once per collision object per frame, and then shared by all the pairs
+  * the object takes part in.
+  *
+  * If the mask keeps pre-rotated masks, the angle of the object is on one of their angle buckets,
+  * and the position is whole, the pre-rotated mask is sampled instead, only translated. See RotatedMaskCache.
+  * The hulls and the bounding boxes are still those of the mask of the object, transformed in full,
+  * so the answers are the same with or without the pre-rotated mask.
+  *
+  * The collision objects of a batch are prepared together: the points of all their hulls and sub-hulls are gathered
+  * in one TransformArena and transformed in one pass, and each object then takes its transformed hulls from there.
+  *
+  * The transformed hulls are kept as compact polygons, which the pair test goes through without touching
+  * any shared pointers, see CompactConvexPolygon. The sub-hulls are only kept as shared polygons
+  * if some hull has more points than a compact polygon can hold.
+  *
+  * If the transformation has no inverse, the object can never collide,
+  * and the hull is null.
+  */
+class PreparedObject {
+
+public:
+
+	/** A transformed hull as a plain value. Two of them always fit together in the buffer of ConvexClipper. */
+	typedef CompactConvexPolygon<ConvexClipper::capacity / 2> CompactHull;
+
+	const std::shared_ptr<const CollisionInfo> collInfo;
+
+	/** The mask that is sampled, which is either the mask of the collision object or a pre-rotated mask of it. */
+	const std::shared_ptr<const Mask> mask;
+
+	/** The transformation of the sampled mask, which is only a translation for a pre-rotated mask. */
+	const Affine transformation;
+
+	/** Whether the transformation has an inverse. */
+	const bool invertible;
+
+	const Affine inverse; //NOTE: Only valid if invertible.
+	const std::shared_ptr<const ConvexCCWPolygon> transformedConvexHull; //NOTE: Null if not invertible.
+
+	/** The transformed convex sub-hulls of the mask, in the same order, or the transformed convex hull if there are none,
+	  * as compact polygons.
+	  */
+	const std::vector<CompactHull> compactHulls; //NOTE: Empty if not invertible, or if any of the hulls does not fit.
+
+	/** The transformed convex sub-hulls of the mask, in the same order, if it has any and they are not compact. */
+	const std::vector<std::shared_ptr<const ConvexCCWPolygon>> transformedSubHulls; //NOTE: Empty if not invertible, or if there are compact hulls.
+
+	/** The axis-aligned bounding boxes of the transformed convex sub-hulls, in the same order. */
+	const std::vector<std::shared_ptr<const BoundingBox>> subHullBoundingBoxes; //NOTE: Empty if not invertible, or if there are compact hulls.
+
+	/** The kind of the transformation, which is also the kind of its inverse. */
+	const TransformKind kind;
+
+	/** Whether the object is only translated by a whole number of pixels, not rotated nor scaled,
+	  * and sampled through its own mask, such that all its points that are on lie within its hull.
+	  */
+	const bool integerTranslationOnly;
+
+	const BitsetBinaryImage* const bitsetImageNull; //NOTE: Handle potential null. Owned by the mask.
+
+private:
+
+	PreparedObject(const std::shared_ptr<const CollisionInfo> aCollInfo,
+			const std::shared_ptr<const Mask> aMask,
+			const Affine aTransformation,
+			const Affine aInverse,
+			const std::shared_ptr<const ConvexCCWPolygon> aTransformedConvexHull,
+			const std::vector<std::shared_ptr<const ConvexCCWPolygon>> & aTransformedSubHulls,
+			const std::vector<std::shared_ptr<const BoundingBox>> & aSubHullBoundingBoxes,
+			std::vector<CompactHull> aCompactHulls);
+
+	/** How a collision object is sampled, and where its hulls are in the arena, found before the hulls are transformed. */
+	struct Sampling {
+		std::shared_ptr<const Mask> mask;
+		Affine transformation;
+		Affine inverse;
+		Affine ownTransformation;
+		unsigned int hullSet; //NOTE: Only valid if the own transformation has an inverse.
+		unsigned int subHullSetsBegin; //NOTE: The sub-hulls are the point sets from subHullSetsBegin up to subHullSetsEnd.
+		unsigned int subHullSetsEnd;
+	};
+
+	/** Finds how a collision object is sampled, and adds the points of its hulls to the arena if it can collide.
+	  *
+	  * @param collInfo the collision object
+	  * @param arena the arena, which the hull and sub-hulls of the mask are added to
+	  * @return how the object is sampled, and the point sets of its hulls
+	  */
+	static const Sampling samplingOf(const std::shared_ptr<const CollisionInfo> collInfo, TransformArena<double> & arena);
+
+	/** Prepares a collision object from its sampling and its hulls, transformed in the arena.
+	  *
+	  * @param collInfo the collision object
+	  * @param sampling the sampling of the object
+	  * @param arena the arena, after all the point sets are transformed
+	  * @return the prepared collision object
+	  */
+	static const std::shared_ptr<const PreparedObject> fromArena(const std::shared_ptr<const CollisionInfo> collInfo,
+			const Sampling & sampling, const TransformArena<double> & arena);
+
+	/** Adds the points of a hull to the arena, see TransformArena::add. */
+	static const unsigned int addHull(const ConvexCCWPolygon & hull, const Affine & transformation, TransformArena<double> & arena);
+
+	/** @return the points of a transformed point set of the arena */
+	static const std::shared_ptr<const std::vector<P>> pointsOf(const TransformArena<double> & arena, const unsigned int set);
+
+	/** Takes a transformed hull from the arena as a compact hull, if it fits.
+	  *
+	  * @param arena the arena, after all the point sets are transformed
+	  * @param set the point set of the hull
+	  * @param transformation the transformation of the mask
+	  * @param compactHulls the compact hulls, which the transformed hull is added to if it fits
+	  * @return whether the hull fits
+	  */
+	static const bool addCompactHull(const TransformArena<double> & arena, const unsigned int set, const Affine & transformation,
+			std::vector<CompactHull> & compactHulls);
+
+	  /** Given a set of points that form a valid convex polygon, that is either clockwise or counter-clockwise,
+	    * return a counter-clockwise convex polygon.
+	    *
+	    * @param points CW or CCW convex points
+	    * @return CCW convex polygon
+	    */
+	static const std::shared_ptr<const ConvexCCWPolygon> assumingValidConvexPolygonPointsTransformToCCWEvenIfCW(
+			const std::shared_ptr<const std::vector<P>> points
+				) {
+
+		const auto size = (*points).size();
+
+		if (size == 0) {
+			return Empty::getEmpty();
+		}
+		else if (size == 1) {
+			return std::shared_ptr<const ConvexCCWPolygon>(new Point((*points).front()));
+		}
+		else if (size == 2) {
+			const auto head = (*points).front();
+			const auto last = (*points).back();
+			return Line::create(head, last);
+		}
+		else { //size >= 3.
+
+			//Get the first 3 points, and check their direction.
+
+			const auto p1 = (*points).front();
+			const auto p2 = *(++(*points).begin());
+			const auto p3 = *(++++(*points).begin());
+
+			const auto v1 = p2.minus(p1);
+			const auto v2 = p3.minus(p1);
+
+			const auto v1XV2 = v1.cross(v2);
+
+			if (v1XV2 == 0) {
+				std::cerr << "A valid convex polygon will never have 3 points on the same line in the convex hull." << std::endl;
+				throw 1;
+			}
+			else if (v1XV2 > 0) {
+
+				//The polygon is CCW, do nothing.
+				return Polygon::createUtterlyUnsafelyNotChecked(points);
+			}
+			else { // v1 X v2 < 0.0.
+
+				//The polygon is CW, reverse in other to get CCW.
+
+				const auto pointsReverse = new std::vector<P>(*points);
+				std::reverse(pointsReverse->begin(), pointsReverse->end());
+
+				return Polygon::createUtterlyUnsafelyNotChecked(std::shared_ptr<const std::vector<P>>(pointsReverse));
+			}
+		}
+	}
+
+public:
+
+	/** The axis-aligned bounding box of the transformed convex hull, which the collision info keeps.
+	  *
+	  * NOTE: Only meaningful if invertible.
+	  */
+	const BoundingBox & tightBoundingBox() const {
+		return (*collInfo).gBoundingBox();
+	}
+
+	  /** Find the affine transformations, their inverses, the transformed convex hulls and the bounding boxes of collision objects,
+	    * transforming the hulls of all of them in one pass.
+	    *
+	    * @param collInfos the collision objects
+	    * @param arena the arena the hulls are transformed in, which is cleared first, and may be reused for the next batch
+	    * @return the prepared collision objects, in the same order
+	    */
+	static const std::vector<std::shared_ptr<const PreparedObject>> prepareAll(
+			const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos, TransformArena<double> & arena);
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_PAIRWISE_PREPAREDOBJECT_HPP_ */
@@ -0,0 +1,110 @@
+/* PreparedObjectCache.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <utility>
+
+#include "PreparedObjectCache.hpp"
+
+namespace poxelcoll {
+
+const std::shared_ptr<const PreparedObject> PreparedObjectCache::preparedOf(const std::shared_ptr<const CollisionInfo> & collInfo) {
+	return preparedOfAll(std::vector<std::shared_ptr<const CollisionInfo>>(1, collInfo)).front();
+}
+
+const std::vector<std::shared_ptr<const PreparedObject>> PreparedObjectCache::preparedOfAll(
+		const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) {
+
+	std::vector<std::shared_ptr<const PreparedObject>> result(collInfos.size());
+
+	std::vector<std::shared_ptr<const CollisionInfo>> missingCollInfos;
+	std::vector<unsigned int> missingPositions;
+
+	for (unsigned int i = 0; i < collInfos.size(); i++) {
+
+		const auto & collInfo = collInfos[i];
+		auto & shard = shardOf((*collInfo).gId());
+
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		const auto found = shard.preparedObjects.find((*collInfo).gId());
+		if (found != shard.preparedObjects.end() && (*(*found).second).collInfo.get() == collInfo.get()) {
+			result[i] = (*found).second;
+		}
+		else {
+			missingCollInfos.push_back(collInfo);
+			missingPositions.push_back(i);
+		}
+	}
+
+	if (missingCollInfos.empty()) {
+		return result;
+	}
+
+	//Prepared outside the locks of the shards, so other threads are not held up.
+	//If two threads prepare the same object at once, both results are equivalent.
+
+	std::unique_ptr<TransformArena<double>> arena;
+	{
+		std::lock_guard<std::mutex> lock(arenasMutex);
+
+		if (!arenas.empty()) {
+			arena = std::move(arenas.back());
+			arenas.pop_back();
+		}
+	}
+	if (arena.get() == 0) {
+		arena.reset(new TransformArena<double>());
+	}
+
+	const auto prepared = PreparedObject::prepareAll(missingCollInfos, *arena);
+
+	{
+		std::lock_guard<std::mutex> lock(arenasMutex);
+		arenas.push_back(std::move(arena));
+	}
+
+	for (unsigned int i = 0; i < prepared.size(); i++) {
+
+		const auto id = (*missingCollInfos[i]).gId();
+		auto & shard = shardOf(id);
+
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		if (shard.preparedObjects.size() >= maxEntries / shardCount && shard.preparedObjects.find(id) == shard.preparedObjects.end()) {
+			shard.preparedObjects.clear();
+		}
+		shard.preparedObjects[id] = prepared[i];
+
+		result[missingPositions[i]] = prepared[i];
+	}
+
+	return result;
+}
+
+void PreparedObjectCache::beginFrame() {
+
+	for (unsigned int i = 0; i < shardCount; i++) {
+		std::lock_guard<std::mutex> lock(shards[i].mutex);
+		shards[i].preparedObjects.clear();
+	}
+}
+
+}
@@ -0,0 +1,105 @@
+/* PreparedObjectCache.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_PAIRWISE_PREPAREDOBJECTCACHE_HPP_
+#define POXELCOLL_COLLISION_PAIRWISE_PREPAREDOBJECTCACHE_HPP_
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <stdint.h>
+
+#include "PreparedObject.hpp"
+#include "../../CollisionInfo.hpp"
+#include "../../geometry/matrix/TransformArena.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollisionpairwise
+  *
+  * Keeps the prepared collision object of each id for the current frame, so each collision object is only prepared once per frame.
+  *
+  * The frame is declared by the caller: beginFrame forgets all prepared collision objects, such that objects
+  * that are gone do not keep their masks, pre-rotated masks and hulls alive.
+  * Within a frame, the prepared object of an id is only reused if it was prepared from the very same collision info,
+  * so a collision info that is given anew within the frame is prepared again, and never mistaken for another one.
+  *
+  * The cache is safe to use from several threads at once. The ids are spread over shards by a hash,
+  * each with its own lock, so threads preparing different objects seldom wait for each other.
+  * A shard is also cleared when it grows beyond its share of maxEntries, in case beginFrame is never called.
+  *
+  * The objects that are not yet prepared are prepared together, with their hulls transformed in one pass
+  * (see PreparedObject::prepareAll). The arenas for that are kept from frame to frame, one for each thread
+  * that prepares at the same time, so preparing stops allocating for them once they have held the largest batch.
+  */
+class PreparedObjectCache {
+
+private:
+
+	/** The ids that hash to the same shard, and their lock. */
+	struct Shard {
+		std::mutex mutex;
+		std::unordered_map<int, std::shared_ptr<const PreparedObject>> preparedObjects;
+	};
+
+	/** The number of shards, a power of 2. */
+	static const unsigned int shardCount = 64;
+
+	mutable Shard shards[shardCount];
+
+	/** The arenas that are not in use, and their lock. */
+	std::mutex arenasMutex;
+	std::vector<std::unique_ptr<TransformArena<double>>> arenas;
+
+	/** The shard of an id. The id is mixed first, since ids are often consecutive. */
+	Shard & shardOf(const int id) const {
+		return shards[(((uint32_t) id) * 0x9E3779B9u) >> 26];
+	}
+
+public:
+
+	/** The number of ids from which the cache is cleared, shard by shard. */
+	static const unsigned int maxEntries = 1 << 16;
+
+	/** The prepared collision object of the given collision info, preparing it if it was not already in this frame.
+	  *
+	  * @param collInfo the collision object
+	  * @return the prepared collision object
+	  */
+	const std::shared_ptr<const PreparedObject> preparedOf(const std::shared_ptr<const CollisionInfo> & collInfo);
+
+	/** The prepared collision objects of the given collision infos, preparing those that were not already in this frame together.
+	  *
+	  * @param collInfos the collision objects
+	  * @return the prepared collision objects, in the same order
+	  */
+	const std::vector<std::shared_ptr<const PreparedObject>> preparedOfAll(
+			const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos);
+
+	/** Begins a new frame, forgetting all prepared collision objects. */
+	void beginFrame();
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_PAIRWISE_PREPAREDOBJECTCACHE_HPP_ */
@@ -0,0 +1,74 @@
+/* SeparatingAxisCache.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SeparatingAxisCache.hpp"
+
+namespace poxelcoll {
+
+const bool SeparatingAxisCache::lookUp(const int id1, const int id2, P & axis) const {
+
+	const auto aKey = key(id1, id2);
+	auto & shard = shardOf(aKey);
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	const auto found = shard.axes.find(aKey);
+
+	if (found == shard.axes.end()) {
+		return false;
+	}
+	else {
+		axis = (*found).second;
+		return true;
+	}
+}
+
+void SeparatingAxisCache::store(const int id1, const int id2, const P & axis) {
+
+	const auto aKey = key(id1, id2);
+	auto & shard = shardOf(aKey);
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	const auto found = shard.axes.find(aKey);
+
+	if (found != shard.axes.end()) {
+		(*found).second = axis;
+	}
+	else {
+		if (shard.axes.size() >= maxEntries / shardCount) {
+			shard.axes.clear();
+		}
+		shard.axes.insert(std::make_pair(aKey, axis));
+	}
+}
+
+void SeparatingAxisCache::forget(const int id1, const int id2) {
+
+	const auto aKey = key(id1, id2);
+	auto & shard = shardOf(aKey);
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	shard.axes.erase(aKey);
+}
+
+}
@@ -0,0 +1,105 @@
+/* SeparatingAxisCache.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_PAIRWISE_SEPARATINGAXISCACHE_HPP_
+#define POXELCOLL_COLLISION_PAIRWISE_SEPARATINGAXISCACHE_HPP_
+
+#include <mutex>
+#include <unordered_map>
+
+#include <stdint.h>
+
+#include "../../DataTypes.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollisionpairwise
+  *
+  * Remembers the last axis that separated each pair of collision objects.
+  *
+  * Objects move little from frame to frame, so an axis that separated a pair in one frame
+  * usually also separates it in the next, which can then be checked with a single projection of each object.
+  *
+  * The cache is safe to use from several threads at once. The pairs are spread over shards by a hash of their key,
+  * each with its own lock, so threads testing different pairs seldom wait for each other.
+  * A shard is cleared when it grows beyond its share of maxEntries, so pairs that are no longer tested
+  * do not keep it growing.
+  */
+class SeparatingAxisCache {
+
+private:
+
+	/** The pairs whose keys hash to the same shard, and their lock. */
+	struct Shard {
+		std::mutex mutex;
+		std::unordered_map<uint64_t, P> axes;
+	};
+
+	/** The number of shards, a power of 2. */
+	static const unsigned int shardCount = 64;
+
+	mutable Shard shards[shardCount];
+
+	/** The key does not depend on the order of the ids. */
+	static const uint64_t key(const int id1, const int id2) {
+		const auto low = (uint32_t) (id1 < id2 ? id1 : id2);
+		const auto high = (uint32_t) (id1 < id2 ? id2 : id1);
+		return (((uint64_t) low) << 32) | (uint64_t) high;
+	}
+
+	/** The shard of a key. The key is mixed first, since ids are often consecutive. */
+	Shard & shardOf(const uint64_t aKey) const {
+		return shards[(aKey * 0x9E3779B97F4A7C15ULL) >> 58];
+	}
+
+public:
+
+	/** The number of pairs from which the cache is cleared, shard by shard. */
+	static const unsigned int maxEntries = 1 << 16;
+
+	/** Looks up the last separating axis of the pair.
+	  *
+	  * @param id1 the id of the first collision object
+	  * @param id2 the id of the second collision object
+	  * @param axis set to the axis if found, else left as it is
+	  * @return whether an axis was found
+	  */
+	const bool lookUp(const int id1, const int id2, P & axis) const;
+
+	/** Remembers the separating axis of the pair.
+	  *
+	  * @param id1 the id of the first collision object
+	  * @param id2 the id of the second collision object
+	  * @param axis the axis that separated the objects
+	  */
+	void store(const int id1, const int id2, const P & axis);
+
+	/** Forgets the separating axis of the pair, such as when the objects overlap.
+	  *
+	  * @param id1 the id of the first collision object
+	  * @param id2 the id of the second collision object
+	  */
+	void forget(const int id1, const int id2);
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_PAIRWISE_SEPARATINGAXISCACHE_HPP_ */
@@ -19,101 +19,313 @@
  * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <iostream>
+#include <unordered_map>
+
 #include "SimplePixelPerfectPairwise.hpp"
 #include "../pixelperfect/PixelPerfect.hpp"
-#include "../../geometry/matrix/Transformation.hpp"
+#include "../pixelperfect/AffineSpanSampler.hpp"
+#include "../pixelperfect/BitmaskOverlap.hpp"
+#include "../../geometry/convexccwpolygon/CompactConvexPolygon.hpp"
+#include "../../geometry/convexccwpolygon/ConvexClipper.hpp"
 #include "../../geometry/convexccwpolygon/PolygonIntersection.hpp"
+#include "../../geometry/convexccwpolygon/SeparatingAxis.hpp"
 
 namespace poxelcoll {
 
+SimplePixelPerfectPairwise::SimplePixelPerfectPairwise() :
+		preparedObjects(new PreparedObjectCache()), separatingAxes(new SeparatingAxisCache()) {
+}
+
+void SimplePixelPerfectPairwise::beginFrame() const {
+	(*preparedObjects).beginFrame();
+}
+
 const bool SimplePixelPerfectPairwise::testForCollision(
 		const std::shared_ptr<const CollisionInfo> collInfo1,
 		const std::shared_ptr<const CollisionInfo> collInfo2) const {
 
-	const auto mask1 = (*collInfo1).gMask();
-	const auto mask2 = (*collInfo2).gMask();
+	return testPrepared(*(*preparedObjects).preparedOf(collInfo1), *(*preparedObjects).preparedOf(collInfo2));
+}
+
+const boost::dynamic_bitset<> SimplePixelPerfectPairwise::testForCollisions(
+		const std::vector<CollisionPair> & pairs,
+		const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) const {
 
-	const auto transformationMatrix1 = Transformation::getTransformationMatrix(collInfo1);
-	const auto transformationMatrix2 = Transformation::getTransformationMatrix(collInfo2);
+	std::unordered_map<int, unsigned int> indexOfId;
+	for (unsigned int i = 0; i < collInfos.size(); i++) {
+		indexOfId[(*collInfos[i]).gId()] = i;
+	}
 
-	const auto inv1Null = (*transformationMatrix1).inverseNull(); //NOTE: Handle null.
-	const auto inv2Null = (*transformationMatrix2).inverseNull(); //NOTE: Handle null.
+	//The collision objects the pairs refer to are found first, such that they are prepared together,
+	//with all their hulls transformed in one pass.
 
-	if (inv1Null == 0 || inv2Null == 0) { //Handling if any of the matrices are null.
-		return false; //If the inverse is not well-defined, there is no collision (no inverse == line without width or similar).
+	const auto indexOf = [&indexOfId](const int id) {
+
+		const auto found = indexOfId.find(id);
+		if (found == indexOfId.end()) {
+			std::cerr << "A pair referred to a collision object that was not given." << std::endl;
+			throw 1;
+		}
+		return (*found).second;
+	};
+
+	std::vector<unsigned char> referred(collInfos.size(), 0);
+	std::vector<unsigned int> referredIndices;
+	std::vector<std::shared_ptr<const CollisionInfo>> referredCollInfos;
+
+	for (auto i = pairs.begin(); i != pairs.end(); i++) {
+		const int ids[] = { (*i).id1, (*i).id2 };
+		for (unsigned int j = 0; j < 2; j++) {
+			const auto index = indexOf(ids[j]);
+			if (referred[index] == 0) {
+				referred[index] = 1;
+				referredIndices.push_back(index);
+				referredCollInfos.push_back(collInfos[index]);
+			}
+		}
 	}
-	else { //None of the matrices are null.
 
-		//There is a well-defined inverse, continue.
+	const auto referredPrepared = (*preparedObjects).preparedOfAll(referredCollInfos);
 
-		const std::shared_ptr<const Matrix> inv1(inv1Null);
-		const std::shared_ptr<const Matrix> inv2(inv2Null);
+	//Only the objects that are referred to are prepared, so the others stay null.
+	std::vector<std::shared_ptr<const PreparedObject>> preparedNulls(collInfos.size());
+	for (unsigned int i = 0; i < referredIndices.size(); i++) {
+		preparedNulls[referredIndices[i]] = referredPrepared[i];
+	}
 
-		const auto transConHull1 = assumingValidConvexPolygonPointsTransformToCCWEvenIfCW(
-				(*transformationMatrix1).transformPoints(*(*(*mask1).convexHull()).points())
-		);
-		const auto transConHull2 = assumingValidConvexPolygonPointsTransformToCCWEvenIfCW(
-				(*transformationMatrix2).transformPoints(*(*(*mask2).convexHull()).points())
-		);
-		const auto approxBoundingBox1 = Transformation::approximateBoundingBox(transformationMatrix1, (*mask1).boundingBox());
-		const auto approxBoundingBox2 = Transformation::approximateBoundingBox(transformationMatrix2, (*mask2).boundingBox());
+	const auto preparedOf = [&indexOf, &preparedNulls](const int id) -> const PreparedObject & {
+		return *preparedNulls[indexOf(id)];
+	};
 
-		//If both full, check for intersection.
-		//If not both full, find the intersection.
+	boost::dynamic_bitset<> result(pairs.size());
 
-		const auto otherIntersection = PolygonIntersection::intersection(
-				transConHull1, transConHull2,
-				(*mask1).isPolygonFull(), (*mask2).isPolygonFull(),
-				std::shared_ptr<const BoundingBox>(new BoundingBox(approxBoundingBox1)),
-				std::shared_ptr<const BoundingBox>(new BoundingBox(approxBoundingBox2))
-		);
+	for (unsigned int i = 0; i < pairs.size(); i++) {
+		if (testPrepared(preparedOf(pairs[i].id1), preparedOf(pairs[i].id2))) {
+			result[i] = 1;
+		}
+	}
 
-		if (otherIntersection.getIsRight()) { //NOTE: Is right.
-			const auto collisionIntersection = otherIntersection.getRight();
+	return result;
+}
+
+const bool SimplePixelPerfectPairwise::testPrepared(const PreparedObject & prepared1, const PreparedObject & prepared2) const {
+
+	const auto mask1 = prepared1.mask;
+	const auto mask2 = prepared2.mask;
 
-			const auto testFunction = generalTestFunction(mask1, mask2, inv1, inv2);
+	if (!prepared1.invertible || !prepared2.invertible) { //Handling if any of the transformations have no inverse.
+		return false; //If the inverse is not well-defined, there is no collision (no inverse == line without width or similar).
+	}
+	else if (!prepared1.tightBoundingBox().intersects(prepared2.tightBoundingBox())) {
+		return false; //The bounding boxes of the transformed convex hulls over-approximate the objects, so no overlap means no collision.
+	}
+	else if ((*mask1).isPolygonFull() && (*mask2).isPolygonFull()) {
+		return testFullPrepared(prepared1, prepared2);
+	}
+	else if (prepared1.integerTranslationOnly && prepared2.integerTranslationOnly
+			&& prepared1.bitsetImageNull != 0 && prepared2.bitsetImageNull != 0) {
 
-			//Given the intersection, test the pixels by taking a pixel in the intersection polygon,
-			//and using the inverse transformation matrices to get the corresponding point in the
-			//binary image (or if full, just true).
+		//Only bitset images translated by whole pixels, so the images can be compared directly, word by word.
+		//The point (x, y) is then sampled at exactly the pixel (x + xc, y + yc), which lies within the hull,
+		//so testing all the pixels gives the same answer as testing the points near the intersection of the hulls.
+		//At fractional positions, a point that rounds to a pixel that is on may lie outside the hull, so those are not done here.
 
-			const auto collisionIntersectionType = (*collisionIntersection).getType();
+		return BitmaskOverlap::overlaps(*prepared1.bitsetImageNull, *prepared2.bitsetImageNull,
+				(int) (prepared1.inverse.xc() - prepared2.inverse.xc()), (int) (prepared1.inverse.yc() - prepared2.inverse.yc()));
+	}
+	else if (!prepared1.compactHulls.empty() && !prepared2.compactHulls.empty()) {
 
-			switch (collisionIntersectionType) {
-			case ConvexCCWType::PointT : {
+		//Only the pairs of hulls whose bounding boxes overlap are intersected. The compact hulls lie next to each other,
+		//so going through the pairs follows no pointers, and clipping them is cheap enough that the separating axis
+		//theorem is not tried first.
 
-				const auto a = (*collisionIntersection).getAPoint();
+		for (auto hull1 = prepared1.compactHulls.begin(); hull1 != prepared1.compactHulls.end(); hull1++) {
 
-				return PixelPerfect::collisionTest(a, testFunction);
+			if (!(*hull1).boundsIntersect(prepared2.tightBoundingBox())) {
+				continue;
 			}
-			case ConvexCCWType::LineT : {
 
-				const auto a = (*collisionIntersection).getALine();
+			for (auto hull2 = prepared2.compactHulls.begin(); hull2 != prepared2.compactHulls.end(); hull2++) {
 
-				return PixelPerfect::collisionTest(a, testFunction);
+				if ((*hull1).boundsIntersect(*hull2) && testCompactHulls(prepared1, prepared2, *hull1, *hull2)) {
+					return true;
+				}
 			}
-			case ConvexCCWType::PolygonT : {
+		}
+
+		return false;
+	}
+	else if (prepared1.transformedSubHulls.empty() && prepared2.transformedSubHulls.empty()) {
+		return testHulls(prepared1, prepared2, prepared1.transformedConvexHull, prepared2.transformedConvexHull,
+				std::shared_ptr<const BoundingBox>(), std::shared_ptr<const BoundingBox>());
+	}
+	else {
 
-				const auto a = (*collisionIntersection).getAPolygon();
+		//Only the pairs of sub-hulls that overlap are intersected, which is checked first by their bounding boxes,
+		//and then by the separating axis theorem, since that does not allocate.
+		//An object without sub-hulls has its convex hull as its only sub-hull.
 
-				return PixelPerfect::collisionTest(a, testFunction);
-			}
-			case ConvexCCWType::EmptyT : {
-				return false;
-			}
-			default: {
-				std::cerr << "Did not match any of the ConvexCCWTypes.";
-				throw 1;
+		const auto count1 = prepared1.transformedSubHulls.empty() ? 1 : prepared1.transformedSubHulls.size();
+		const auto count2 = prepared2.transformedSubHulls.empty() ? 1 : prepared2.transformedSubHulls.size();
+
+		for (unsigned int i = 0; i < count1; i++) {
+
+			const auto hull1 = prepared1.transformedSubHulls.empty() ? prepared1.transformedConvexHull : prepared1.transformedSubHulls[i];
+			const auto box1Null = prepared1.transformedSubHulls.empty() ? std::shared_ptr<const BoundingBox>() : prepared1.subHullBoundingBoxes[i];
+			const auto & box1 = box1Null.get() != 0 ? *box1Null : prepared1.tightBoundingBox();
+
+			if (!box1.intersects(prepared2.tightBoundingBox())) {
+				continue;
 			}
+
+			for (unsigned int j = 0; j < count2; j++) {
+
+				const auto hull2 = prepared2.transformedSubHulls.empty() ? prepared2.transformedConvexHull : prepared2.transformedSubHulls[j];
+				const auto box2Null = prepared2.transformedSubHulls.empty() ? std::shared_ptr<const BoundingBox>() : prepared2.subHullBoundingBoxes[j];
+				const auto & box2 = box2Null.get() != 0 ? *box2Null : prepared2.tightBoundingBox();
+
+				if (box1.intersects(box2) && SeparatingAxis::overlaps(*(*hull1).points(), *(*hull2).points())
+						&& testHulls(prepared1, prepared2, hull1, hull2, box1Null, box2Null)) {
+					return true;
+				}
 			}
 		}
-		else { //NOTE: Is left.
-			const auto hasIntersection = *otherIntersection.getLeft();
-			return hasIntersection;
-		}
+
+		return false;
 	}
 }
 
+const bool SimplePixelPerfectPairwise::testCompactHulls(const PreparedObject & prepared1, const PreparedObject & prepared2,
+		const PreparedObject::CompactHull & hull1, const PreparedObject::CompactHull & hull2) const {
+
+	//Two compact hulls always fit in the buffer of the clipper, and the hulls of masks are never points nor lines,
+	//so the intersection is always found.
+
+	CompactConvexPolygon<ConvexClipper::capacity> intersection;
+
+	if (!hull1.intersection(hull2, intersection)) {
+		std::cerr << "The intersection of two compact hulls should always be found." << std::endl;
+		throw 1;
+	}
+
+	const AffineSpanSampler sampler(*prepared1.mask, prepared1.inverse, prepared1.kind,
+			*prepared2.mask, prepared2.inverse, prepared2.kind);
+
+	return PixelPerfect::spanTest(intersection, sampler);
 }
 
+const bool SimplePixelPerfectPairwise::testHulls(const PreparedObject & prepared1, const PreparedObject & prepared2,
+		const std::shared_ptr<const ConvexCCWPolygon> transConHull1, const std::shared_ptr<const ConvexCCWPolygon> transConHull2,
+		const std::shared_ptr<const BoundingBox> box1Null, const std::shared_ptr<const BoundingBox> box2Null) const {
 
+	const auto mask1 = prepared1.mask;
+	const auto mask2 = prepared2.mask;
+
+	const auto & inv1 = prepared1.inverse;
+	const auto & inv2 = prepared2.inverse;
+
+	//The intersection is found on the stack if the hulls are small enough, which they nearly always are.
+	//At most one mask is full here, so the intersection is always needed.
+
+	const auto points1 = (*transConHull1).points();
+	const auto points2 = (*transConHull2).points();
+
+	if (points1.get() == 0 || points2.get() == 0) { //Empty hulls never overlap.
+		return false;
+	}
+
+	ConvexClipper::Buffer buffer;
+	const P * intersectionPoints = 0;
+	unsigned int intersectionSize = 0;
+
+	if (ConvexClipper::intersect((*points1).data(), (*points1).size(), (*points2).data(), (*points2).size(),
+			buffer, intersectionPoints, intersectionSize)) {
+
+		const AffineSpanSampler sampler(*mask1, inv1, prepared1.kind, *mask2, inv2, prepared2.kind);
+
+		return PixelPerfect::spanTest(intersectionPoints, intersectionSize, sampler);
+	}
+
+	//If both full, check for intersection.
+	//If not both full, find the intersection.
+
+	const auto otherIntersection = PolygonIntersection::intersection(
+			transConHull1, transConHull2,
+			(*mask1).isPolygonFull(), (*mask2).isPolygonFull(),
+			box1Null, box2Null
+	);
+
+	if (otherIntersection.getIsRight()) { //NOTE: Is right.
+		const auto collisionIntersection = otherIntersection.getRight();
+
+		const AffineSpanSampler sampler(*mask1, inv1, prepared1.kind, *mask2, inv2, prepared2.kind);
+
+		//Given the intersection, test the pixels by going through the spans of the intersection polygon,
+		//and using the inverse transformations to get the corresponding points in the
+		//binary images (or if full, just true).
+
+		const auto collisionIntersectionType = (*collisionIntersection).getType();
+
+		switch (collisionIntersectionType) {
+		case ConvexCCWType::PointT : {
+
+			const auto a = (*collisionIntersection).getAPoint();
+
+			return PixelPerfect::spanTest(a, sampler);
+		}
+		case ConvexCCWType::LineT : {
+
+			const auto a = (*collisionIntersection).getALine();
+
+			return PixelPerfect::spanTest(a, sampler);
+		}
+		case ConvexCCWType::PolygonT : {
+
+			const auto a = (*collisionIntersection).getAPolygon();
+
+			return PixelPerfect::spanTest(a, sampler);
+		}
+		case ConvexCCWType::EmptyT : {
+			return false;
+		}
+		default: {
+			std::cerr << "Did not match any of the ConvexCCWTypes.";
+			throw 1;
+		}
+		}
+	}
+	else { //NOTE: Is left.
+		const auto hasIntersection = *otherIntersection.getLeft();
+		return hasIntersection;
+	}
+}
+
+const bool SimplePixelPerfectPairwise::testFullPrepared(const PreparedObject & prepared1, const PreparedObject & prepared2) const {
+
+	const auto id1 = (*prepared1.collInfo).gId();
+	const auto id2 = (*prepared2.collInfo).gId();
+
+	const auto points1 = (*prepared1.transformedConvexHull).points();
+	const auto points2 = (*prepared2.transformedConvexHull).points();
+
+	if (points1.get() == 0 || points2.get() == 0) { //Empty hulls never overlap.
+		return false;
+	}
+
+	P axis(0.0, 0.0);
+
+	if ((*separatingAxes).lookUp(id1, id2, axis) && SeparatingAxis::separates(*points1, *points2, axis)) {
+		return false;
+	}
+	else if (SeparatingAxis::findSeparatingAxis(*points1, *points2, axis)) {
+		(*separatingAxes).store(id1, id2, axis);
+		return false;
+	}
+	else {
+		(*separatingAxes).forget(id1, id2);
+		return true;
+	}
+}
+
+}
@@ -26,11 +26,12 @@
 #include <vector>
 
 #include "Pairwise.hpp"
+#include "PreparedObject.hpp"
+#include "PreparedObjectCache.hpp"
+#include "SeparatingAxisCache.hpp"
 #include "../../DataTypes.hpp"
 #include "../../CollisionInfo.hpp"
 #include "../../mask/Mask.hpp"
-#include "../../geometry/convexccwpolygon/DataTypes.hpp"
-#include "../../geometry/matrix/Matrix.hpp"
 
 namespace poxelcoll {
 
@@ -44,15 +45,28 @@ namespace poxelcoll {
   * Strictly over-approximating bounding boxes are used to speed up collision detection
   * by excluding collision objects that do not overlap.
   *
+  * If both collision objects are only translated by whole pixels (not rotated nor scaled), and both masks
+  * have bitset binary images, the images are compared directly 64 pixels at a time.
+  * A collision object at a whole position whose angle has a pre-rotated mask (see RotatedMaskCache) is sampled through that mask,
+  * only translated, while the points that are tested are still found from its own hulls.
+  *
   * '''Method'''
   *
-  * The implementation first checks the approximate bounding box found by
-  * transforming the bounding box according to the collision objects transformation data,
-  * and then finding the axis-aligned bounding box of the transformed bounding box.
-  * This is efficient, but not very precise.
-  * If they still collide, the detection goes on, else it stops with false.
-  * Then the convex hulls of the collision objects is transformed in linear time of the points on the hulls themselves.
-  * The intersection of the convex hulls are then found, again in linear time of the points on the hulls themselves.
+  * Each collision object is first prepared, once per frame (see beginFrame): the affine transformation and its inverse are found,
+  * the convex hull of the mask is transformed in linear time of the points on the hull,
+  * together with the hulls of all the other objects of the batch, in one pass (see TransformArena),
+  * and the axis-aligned bounding box of the transformed hull is found. See PreparedObject.
+  * The implementation then checks whether those bounding boxes overlap.
+  * If they do, the detection goes on, else it stops with false.
+  * The intersection of the convex hulls are then found, by clipping one hull by the edges of the other
+  * into a buffer on the stack, such that nothing is allocated (see ConvexClipper).
+  * The transformed hulls are kept as compact polygons (see CompactConvexPolygon), so neither reference counts
+  * nor virtual calls are involved. Only for hulls with very many points are the shared polygons used instead,
+  * and PolygonIntersection if they do not fit in the buffer, which is linear in the points on the hulls.
+  *
+  * Masks that their convex hull over-approximates badly, such as L-shapes and rings, also have a few convex sub-hulls
+  * (see Mask::subHullsNull). For those, the above is done for each pair of transformed sub-hulls
+  * whose bounding boxes overlap, instead of for the convex hulls, which makes the area that is tested much smaller.
   *
   * If the intersection is found to be empty, the objects do not collide.
   * Else, all the points that overlaps the intersection is found:
@@ -65,7 +79,9 @@ namespace poxelcoll {
   *
   * In general, the above method stops as soon as a colliding pixel has been found.
   * Furthermore, if both of the collision objects are filled (ie. they have no binary image),
-  * the method stops the moment it has been decided whether or not there is an intersection.
+  * the intersection is not found at all. Instead, the transformed convex hulls are tested
+  * for overlap with the separating axis theorem, trying first the axis that separated the pair the last time
+  * it was tested, if any. Since objects move little between frames, that single axis usually decides the test.
   *
   * This method is generally very performant if the collision objects (including their
   * binary images) are well approximated by their convex hulls.
@@ -95,120 +111,90 @@ class SimplePixelPerfectPairwise : public virtual Pairwise {
 
 private:
 
-	  /** Given a set of points that form a valid convex polygon, that is either clockwise or counter-clockwise,
-	    * return a counter-clockwise convex polygon.
+	  /** Given two prepared collision objects, determine whether there is a collision between them.
 	    *
-	    * @param points CW or CCW convex points
-	    * @return CCW convex polygon
+	    * @param prepared1 first prepared collision object
+	    * @param prepared2 second prepared collision object
+	    * @return whether there is a collision or not between the two objects
 	    */
-	static const std::shared_ptr<const ConvexCCWPolygon> assumingValidConvexPolygonPointsTransformToCCWEvenIfCW(
-			const std::shared_ptr<const std::vector<P>> points
-				) {
-
-		const auto size = (*points).size();
-
-		if (size == 0) {
-			return Empty::getEmpty();
-		}
-		else if (size == 1) {
-			return std::shared_ptr<const ConvexCCWPolygon>(new Point((*points).front()));
-		}
-		else if (size == 2) {
-			const auto head = (*points).front();
-			const auto last = (*points).back();
-			return Line::create(head, last);
-		}
-		else { //size >= 3.
-
-			//Get the first 3 points, and check their direction.
-
-			const auto p1 = (*points).front();
-			const auto p2 = *(++(*points).begin());
-			const auto p3 = *(++++(*points).begin());
-
-			const auto v1 = p2.minus(p1);
-			const auto v2 = p3.minus(p1);
-
-			const auto v1XV2 = v1.cross(v2);
-
-			if (v1XV2 == 0) {
-				std::cerr << "A valid convex polygon will never have 3 points on the same line in the convex hull." << std::endl;
-				throw 1;
-			}
-			else if (v1XV2 > 0) {
-
-				//The polygon is CCW, do nothing.
-				return Polygon::createUtterlyUnsafelyNotChecked(points);
-			}
-			else { // v1 X v2 < 0.0.
-
-				//The polygon is CW, reverse in other to get CCW.
-
-				const auto pointsReverse = new std::vector<P>(*points);
-				std::reverse(pointsReverse->begin(), pointsReverse->end());
-
-				return Polygon::createUtterlyUnsafelyNotChecked(std::shared_ptr<const std::vector<P>>(pointsReverse));
-			}
-		}
-	}
-
-	  /** Check whether a point is contained in a binary image.
+	const bool testPrepared(const PreparedObject & prepared1, const PreparedObject & prepared2) const;
+
+	  /** Given two prepared collision objects with invertible transformations and a transformed hull or sub-hull of each,
+	    * determine whether there is a collision between them within the intersection of the hulls.
 	    *
-	    * @param image a binary image
-	    * @param v a point which has a superfluous third coordinate, and which coordinates may be outside the images dimension
-	    * @return whether the image contains the point
+	    * @param prepared1 first prepared collision object
+	    * @param prepared2 second prepared collision object
+	    * @param transConHull1 the transformed hull or sub-hull of the first object
+	    * @param transConHull2 the transformed hull or sub-hull of the second object
+	    * @param box1Null the axis-aligned bounding box of the first hull, or null to have it found if it is needed
+	    * @param box2Null the axis-aligned bounding box of the second hull, or null to have it found if it is needed
+	    * @return whether there is a collision or not between the two objects within the hulls
 	    */
-	static const bool checkImage(const std::shared_ptr<const Mask> image, const P3 v) {
-
-		const auto binaryImageNull = (*image).binaryImageNull(); //NOTE: Handle potential null.
-
-		if (binaryImageNull.get() == 0) {//binaryImageNull is null.
-			return true;
-		}
-		else { //binaryImageNull is not null.
+	const bool testHulls(const PreparedObject & prepared1, const PreparedObject & prepared2,
+			const std::shared_ptr<const ConvexCCWPolygon> transConHull1, const std::shared_ptr<const ConvexCCWPolygon> transConHull2,
+			const std::shared_ptr<const BoundingBox> box1Null, const std::shared_ptr<const BoundingBox> box2Null) const;
 
-			const auto point = IP((int)round(v.gX()), (int)round(v.gY()));
-			const auto x = point.gX();
-			const auto y = point.gY();
-
-			return x >= 0 && x < (int)(*binaryImageNull).width() &&
-				   y >= 0 && y < (int)(*binaryImageNull).height() &&
-				   (*binaryImageNull).hasPoint(x, y);
-		}
-	}
-
-	  /** For 2 images and 2 transformation matrices, give a function that test whether a given point is contained in both images.
+	  /** Given two prepared collision objects with invertible transformations and a compact transformed hull or sub-hull of each,
+	    * determine whether there is a collision between them within the intersection of the hulls.
 	    *
-	    * The transformation matrices is used to map from some coordinate system to that of the images.
+	    * @param prepared1 first prepared collision object
+	    * @param prepared2 second prepared collision object
+	    * @param hull1 the compact hull or sub-hull of the first object
+	    * @param hull2 the compact hull or sub-hull of the second object
+	    * @return whether there is a collision or not between the two objects within the hulls
+	    */
+	const bool testCompactHulls(const PreparedObject & prepared1, const PreparedObject & prepared2,
+			const PreparedObject::CompactHull & hull1, const PreparedObject::CompactHull & hull2) const;
+
+	  /** Given two prepared collision objects with full masks, determine whether their transformed convex hulls overlap,
+	    * trying the cached separating axis of the pair first, and updating the cache.
 	    *
-	    * @param image1 first binary image to test whether a point is contained in
-	    * @param image2 second binary image to test whether a point is contained in
-	    * @param inv1 transform given points to the coordinate system of the first image
-	    * @param inv2 transform given points to the coordinate system of the second image
-	    * @param point whether a point is contained in the given function
-	    * @return first currying yields a test function that yields if a point is contained in both images using the given transformation matrices
+	    * @param prepared1 first prepared collision object
+	    * @param prepared2 second prepared collision object
+	    * @return whether there is a collision or not between the two objects
 	    */
-	static const std::function<bool(IP)> generalTestFunction(const std::shared_ptr<const Mask> image1, const std::shared_ptr<const Mask> image2,
-			const std::shared_ptr<const Matrix> inv1, const std::shared_ptr<const Matrix> inv2) {
+	const bool testFullPrepared(const PreparedObject & prepared1, const PreparedObject & prepared2) const;
 
-		const auto fun = [inv1, inv2, image1, image2](const IP point){
+	/** The prepared collision objects of the current frame. */
+	const std::shared_ptr<PreparedObjectCache> preparedObjects;
 
-			const auto vector = P3(point.gX(), point.gY(), 1.0);
+	/** The last separating axis of each pair of full masks. */
+	const std::shared_ptr<SeparatingAxisCache> separatingAxes;
 
-			const auto imageVector1 = (*inv1).vectorMult(vector);
-			const auto imageVector2 = (*inv2).vectorMult(vector);
 
-			return checkImage(image1, imageVector1) && checkImage(image2, imageVector2);
-		};
+public:
 
-		return fun;
-	}
+	SimplePixelPerfectPairwise();
 
-public:
+	  /** Forgets the prepared collision objects of the previous frame. The separating axes of the pairs are kept,
+	    * since they are what carries over from frame to frame.
+	    */
+	void beginFrame() const;
 
+	  /** Given two collision objects, determine whether there is a collision between them.
+	    *
+	    * Each collision info is prepared only once between two calls of beginFrame, no matter how many pairs
+	    * and calls it takes part in.
+	    *
+	    * @param collInfo1 first collision object
+	    * @param collInfo2 second collision object
+	    * @return whether there is a collision or not between the two objects
+	    */
 	const bool testForCollision(
 			const std::shared_ptr<const CollisionInfo> collInfo1,
 			const std::shared_ptr<const CollisionInfo> collInfo2) const;
+
+	  /** Given a sequence of collision pairs and the collision objects they refer to, determine for each pair whether there is a collision.
+	    *
+	    * Collision objects that are not referred to by any pair are not prepared.
+	    *
+	    * @param pairs the pairs to test, referring to the ids of the collision objects
+	    * @param collInfos the collision objects, which must include every object referred to by the pairs
+	    * @return a bitset with one bit per pair, in the order of the pairs, which is set if the pair collides
+	    */
+	const boost::dynamic_bitset<> testForCollisions(
+			const std::vector<CollisionPair> & pairs,
+			const std::vector<std::shared_ptr<const CollisionInfo>> & collInfos) const;
 };
 
 }
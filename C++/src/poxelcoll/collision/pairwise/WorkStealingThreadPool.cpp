@@ -0,0 +1,176 @@
+/* WorkStealingThreadPool.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorkStealingThreadPool.hpp"
+
+namespace poxelcoll {
+
+WorkStealingThreadPool::WorkStealingThreadPool(const unsigned int threadCount) :
+		stopping(false), generation(0), pendingTasks(0) {
+
+	auto count = threadCount;
+	if (count == 0) {
+		count = std::thread::hardware_concurrency();
+	}
+	if (count == 0) { //The number of hardware threads is not known.
+		count = 1;
+	}
+
+	for (unsigned int i = 0; i < count; i++) {
+		workers.push_back(std::unique_ptr<Worker>(new Worker()));
+	}
+	for (unsigned int i = 0; i < count; i++) {
+		threads.push_back(std::thread([this, i]() {
+			workerLoop(i);
+		}));
+	}
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+
+	for (auto i = threads.begin(); i != threads.end(); i++) {
+		(*i).join();
+	}
+}
+
+const unsigned int WorkStealingThreadPool::gThreadCount() const {
+	return workers.size();
+}
+
+const bool WorkStealingThreadPool::takeTask(const unsigned int workerIndex, std::function<void()> & task) {
+
+	const unsigned int count = workers.size();
+
+	//Own queue first, from the front.
+
+	{
+		auto & own = *workers[workerIndex];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty()) {
+			task = std::move(own.tasks.front());
+			own.tasks.pop_front();
+			return true;
+		}
+	}
+
+	//Steal from the back of the other queues.
+
+	for (unsigned int offset = 1; offset < count; offset++) {
+		auto & other = *workers[(workerIndex + offset) % count];
+		std::lock_guard<std::mutex> lock(other.mutex);
+		if (!other.tasks.empty()) {
+			task = std::move(other.tasks.back());
+			other.tasks.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WorkStealingThreadPool::workerLoop(const unsigned int workerIndex) {
+
+	unsigned long seenGeneration = 0;
+
+	while (true) {
+
+		std::function<void()> task;
+
+		if (takeTask(workerIndex, task)) {
+
+			std::exception_ptr error;
+			try {
+				task();
+			}
+			catch (...) {
+				error = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(poolMutex);
+			if (error && !firstError) {
+				firstError = error;
+			}
+			pendingTasks--;
+			if (pendingTasks == 0) {
+				workDone.notify_all();
+			}
+		}
+		else { //No work anywhere, wait for the next batch.
+
+			std::unique_lock<std::mutex> lock(poolMutex);
+			workAvailable.wait(lock, [this, &seenGeneration]() {
+				return stopping || generation != seenGeneration;
+			});
+			if (stopping) {
+				return;
+			}
+			seenGeneration = generation;
+		}
+	}
+}
+
+void WorkStealingThreadPool::runAll(const std::vector<std::function<void()>> & tasks) {
+
+	if (tasks.empty()) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> runLock(runMutex);
+
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		pendingTasks = tasks.size();
+		firstError = std::exception_ptr();
+	}
+
+	//Deal out the tasks in turn, keeping their order within each queue.
+
+	const unsigned int count = workers.size();
+	for (unsigned int i = 0; i < tasks.size(); i++) {
+		auto & worker = *workers[i % count];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.tasks.push_back(tasks[i]);
+	}
+
+	std::exception_ptr error;
+	{
+		std::unique_lock<std::mutex> lock(poolMutex);
+		generation++;
+		workAvailable.notify_all();
+		workDone.wait(lock, [this]() {
+			return pendingTasks == 0;
+		});
+		error = firstError;
+		firstError = std::exception_ptr();
+	}
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+}
@@ -0,0 +1,103 @@
+/* WorkStealingThreadPool.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_PAIRWISE_WORKSTEALINGTHREADPOOL_HPP_
+#define POXELCOLL_COLLISION_PAIRWISE_WORKSTEALINGTHREADPOOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollisionpairwise
+  *
+  * A fixed-size pool of worker threads that run batches of tasks, balanced by work-stealing.
+  *
+  * '''Method'''
+  *
+  * Each worker has its own double-ended queue of tasks. When a batch is run, its tasks are dealt out
+  * to the queues in turn, in the given order. A worker takes tasks from the front of its own queue,
+  * and when it is empty, it steals tasks from the back of the other queues.
+  * Tasks should therefore be given roughly in order of decreasing cost: the expensive tasks are started first,
+  * and the cheap tasks at the end of the queues are the ones stolen to even out the load.
+  *
+  * The threads are started when the pool is created and kept until it is destroyed,
+  * and sleep while there is no batch to run.
+  */
+class WorkStealingThreadPool {
+
+private:
+
+	struct Worker {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
+
+	std::mutex runMutex; //Only one batch is run at a time.
+
+	std::mutex poolMutex; //Guards the fields below.
+	std::condition_variable workAvailable;
+	std::condition_variable workDone;
+	bool stopping;
+	unsigned long generation;
+	unsigned long pendingTasks;
+	std::exception_ptr firstError;
+
+	const bool takeTask(const unsigned int workerIndex, std::function<void()> & task);
+
+	void workerLoop(const unsigned int workerIndex);
+
+public:
+
+	/** @param threadCount the number of worker threads, or 0 for the number of hardware threads
+	  */
+	WorkStealingThreadPool(const unsigned int threadCount = 0);
+
+	~WorkStealingThreadPool();
+
+	const unsigned int gThreadCount() const;
+
+	/** Run the tasks on the worker threads, and wait until all of them have finished.
+	  *
+	  * The tasks may be run in any order and on any thread, so they must be safe to run concurrently.
+	  * If any task throws, the remaining tasks are still run, and the first error is thrown afterwards.
+	  *
+	  * @param tasks the tasks, preferably ordered from the most to the least expensive
+	  */
+	void runAll(const std::vector<std::function<void()>> & tasks);
+
+private:
+	WorkStealingThreadPool(const WorkStealingThreadPool &);
+	WorkStealingThreadPool & operator=(const WorkStealingThreadPool &);
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_PAIRWISE_WORKSTEALINGTHREADPOOL_HPP_ */
@@ -35,7 +35,10 @@
   * The simple pixel-perfect pairwise collision detection implementation
   * supports transformed pixel-perfect collision relatively efficiently.
   * It also handles filled polygons as well, and uses bounding boxes
-  * for quick pruning.
+  * for quick pruning. Pairs of filled polygons are tested with the separating axis theorem,
+  * and the last separating axis of each pair is cached for the next frame.
+  * The per-object work (transformation matrix, inverse, transformed convex hull and bounding boxes)
+  * is done once per collision object per frame and shared by its pairs.
   * One issue is that its performance and precision can be adversely
   * affected by scaling.
   *
@@ -47,4 +50,8 @@
   * scaling has on performance and precision, but there are no
   * concrete plans for implementing this, and without any requests or desire
   * for implementing it, it may never be implemented.
+  *
+  * The parallel pairwise collision detection tests batches of collision pairs on several threads,
+  * using a work-stealing thread pool and another pairwise collision detection for the individual pairs.
+  * The results are given in the order of the pairs, independent of how the work was divided.
   */
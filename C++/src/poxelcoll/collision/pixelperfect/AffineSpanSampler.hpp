@@ -0,0 +1,589 @@
+/* AffineSpanSampler.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_PIXELPERFECT_AFFINESPANSAMPLER_HPP_
+#define POXELCOLL_COLLISION_PIXELPERFECT_AFFINESPANSAMPLER_HPP_
+
+#include <math.h>
+#include <memory>
+
+#include <stdint.h>
+
+#include "../../binaryimage/BinaryImage.hpp"
+#include "../../binaryimage/BitsetBinaryImage.hpp"
+#include "../../binaryimage/RleBinaryImage.hpp"
+#include "../../binaryimage/OccupancyPyramid.hpp"
+#include "../../mask/Mask.hpp"
+#include "../../mask/MaskExtents.hpp"
+#include "../../geometry/matrix/Affine.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollision
+  *
+  * A span function that tests whether any point in a span is on in two binary images,
+  * each given with the affine transformation that maps points to the coordinate system of the image.
+  *
+  * A point is on in an image if the mapped point, rounded to the nearest integer point, is within the image and on there.
+  * An image that is not given (null) is on everywhere, like a full polygon.
+  *
+  * '''Method'''
+  *
+  * Along a span, the mapped points change by a constant vector for each step in x.
+  * The mapped coordinates are therefore found once at the start of each span, and then stepped incrementally,
+  * so no matrix multiplication is done per point. The rounding and bounds check is done
+  * on the double coordinates directly.
+  *
+  * If a span stays in one row of an image, which is the case when the image is neither rotated nor sheared,
+  * the whole row span is tested at once by the binary image, which some binary images do quickly.
+  *
+  * If a mask has extents, each span is first clipped to the points that map within the extents
+  * of the points on in the image: the extent of the row if the span stays in one row of the image,
+  * otherwise the tight bounds of the whole image.
+  *
+  * If an image has an occupancy pyramid, the span is split into blocks of points, and for each block,
+  * the rectangle of image points it maps to is looked up in the pyramid first. Blocks that map to
+  * an empty part of either image are skipped without testing their points.
+  *
+  * The points of a block are found 64 at a time for each image, as the bits of a word, and the words are compared.
+  * The loop for each image is specialised at compile time for the kind of mapping and the type of binary image,
+  * and chosen once per pair. A full mask is never read. A translation reads a whole part of a row at once,
+  * which for bitset images is a word or two, and for run-length encoded images the runs that overlap it.
+  * An axis-aligned mapping steps through one row, and a quarter turn through one column, so only the coordinate
+  * that changes is stepped and checked. Only other mappings step and check both coordinates.
+  * Bitset images are read inline, run-length encoded images without virtual calls, and other images through
+  * the virtual interface.
+  */
+class AffineSpanSampler {
+
+private:
+
+	/** One image and the affine mapping to it. */
+	struct ImageMapping {
+
+		const BinaryImage* imageNull; //NOTE: Handle potential null.
+		const BitsetBinaryImage* bitsetImageNull; //NOTE: Handle potential null. Set if the image is a bitset image.
+		const RleBinaryImage* rleImageNull; //NOTE: Handle potential null. Set if the image is a run-length encoded image.
+		const OccupancyPyramid* occupancyPyramidNull; //NOTE: Handle potential null.
+		const MaskExtents* extentsNull; //NOTE: Handle potential null.
+		double width;
+		double height;
+
+		//The image point of (x, y) is (xx * x + xy * y + xc, yx * x + yy * y + yc).
+		double xx, xy, xc;
+		double yx, yy, yc;
+
+		ImageMapping(const Mask & mask, const Affine & inverse) :
+				imageNull(mask.binaryImageNull().get()),
+				bitsetImageNull(dynamic_cast<const BitsetBinaryImage*>(imageNull)),
+				rleImageNull(dynamic_cast<const RleBinaryImage*>(imageNull)),
+				occupancyPyramidNull(imageNull == 0 ? 0 : mask.occupancyPyramidNull().get()),
+				extentsNull(imageNull == 0 ? 0 : mask.extentsNull().get()),
+				width(imageNull == 0 ? 0.0 : (*imageNull).width()),
+				height(imageNull == 0 ? 0.0 : (*imageNull).height()),
+				xx(inverse.xx()), xy(inverse.xy()), xc(inverse.xc()),
+				yx(inverse.yx()), yy(inverse.yy()), yc(inverse.yc()) {
+		}
+
+		/** Narrow [low; high] to the x where lower <= a * x + b <= upper. */
+		static void clipLinear(const double a, const double b, const double lower, const double upper,
+				double & low, double & high) {
+
+			if (a == 0.0) {
+				if (!(b >= lower && b <= upper)) {
+					low = HUGE_VAL;
+					high = -HUGE_VAL;
+				}
+			}
+			else {
+				const auto t1 = (lower - b) / a;
+				const auto t2 = (upper - b) / a;
+				low = fmax(low, fmin(t1, t2));
+				high = fmin(high, fmax(t1, t2));
+			}
+		}
+
+		/** Narrow [low; high] to the x where the point (x, y) maps within the extents of the points on in the image.
+		  *
+		  * If the row of the span stays in one row of the image, the extent of that row is used,
+		  * otherwise the extents of the whole image.
+		  */
+		void clip(const int y, double & low, double & high) const {
+
+			if (extentsNull == 0) {
+				return;
+			}
+
+			const auto & extents = *extentsNull;
+
+			if (extents.isEmpty()) {
+				low = HUGE_VAL;
+				high = -HUGE_VAL;
+			}
+			else if (yx == 0.0) {
+
+				const auto v = yy * y + yc;
+
+				if (!(v > -0.5 && v < height - 0.5) || !extents.rowIsOccupied((unsigned int) (v + 0.5))) {
+					low = HUGE_VAL;
+					high = -HUGE_VAL;
+				}
+				else {
+					const auto row = (unsigned int) (v + 0.5);
+					clipLinear(xx, xy * y + xc, extents.rowMin(row) - 0.5, extents.rowMax(row) + 0.5, low, high);
+				}
+			}
+			else {
+				clipLinear(xx, xy * y + xc, extents.firstColumn() - 0.5, extents.lastColumn() + 0.5, low, high);
+				clipLinear(yx, yy * y + yc, extents.firstRow() - 0.5, extents.lastRow() + 0.5, low, high);
+			}
+		}
+
+		/** Whether any of the given number of steps from the image point may be on, when the steps stay in one row
+		  * of the image, ie. the mapping is neither rotated nor sheared. Must not be called without image.
+		  *
+		  * If the steps are single points to the right, the answer is exact, otherwise it is conservative.
+		  */
+		const bool mayHaveOnInRow(const double u, const double v, const int steps) const {
+
+			if (!(v > -0.5 && v < height - 0.5)) {
+				return false;
+			}
+			const auto y = (unsigned int) (v + 0.5);
+
+			double first, last;
+
+			if (xx == 1.0) { //The steps that are within the image, each at the next column.
+				const auto stepFirst = fmax(0.0, floor(-0.5 - u) + 1.0);
+				const auto stepLast = fmin(steps, ceil(width - 0.5 - u) - 1.0);
+				first = floor(u + 0.5) + stepFirst;
+				last = floor(u + 0.5) + stepLast;
+			}
+			else { //The columns between the ends, with a little slack.
+				const auto uEnd = u + xx * steps;
+				first = fmax(0.0, floor(fmin(u, uEnd) + 0.5 - 1e-7));
+				last = fmin(width - 1.0, floor(fmax(u, uEnd) + 0.5 + 1e-7));
+			}
+
+			return first <= last && (*imageNull).hasPointInRow(y, (unsigned int) first, (unsigned int) last);
+		}
+
+		/** Whether any of the given number of steps from the image point may be on, according to the pyramid.
+		  * Without image or pyramid, this is always the case.
+		  */
+		const bool mayHaveOn(const double u, const double v, const int steps) const {
+
+			if (occupancyPyramidNull == 0) {
+				return true;
+			}
+
+			const auto uEnd = u + xx * steps;
+			const auto vEnd = v + yx * steps;
+
+			//A little slack, since the points are stepped to and not found directly.
+			const auto slack = 1e-7;
+
+			return (*occupancyPyramidNull).hasPointIn(
+					(int) floor(fmin(u, uEnd) + 0.5 - slack), (int) floor(fmin(v, vEnd) + 0.5 - slack),
+					(int) floor(fmax(u, uEnd) + 0.5 + slack), (int) floor(fmax(v, vEnd) + 0.5 + slack));
+		}
+	};
+
+	/** Where a mapping is along a span. */
+	struct Cursor {
+		double u; //NOTE: For translations, the column, which is always whole.
+		double v;
+		bool inside; //Whether the row or column that stays the same along the span is within the image.
+		unsigned int fixed; //That row or column.
+		int firstColumn; //NOTE: For translations, the first column a point may round to, which is 1 if column 0 is only reached at u = -0.5.
+	};
+
+	/** The points [0; count[ as the bits of a word. */
+	static const uint64_t lowBits(const int count) {
+		return count == 64 ? ~((uint64_t) 0) : (((uint64_t) 1) << count) - 1;
+	}
+
+	//The image access policies. Each reads one kind of binary image,
+	//with the concrete type known at compile time, such that reads of bitset images are inlined.
+
+	/** Reads any binary image, through the virtual interface. */
+	struct AnyImage {
+		static const bool hasPoint(const ImageMapping & m, const unsigned int x, const unsigned int y) {
+			return (*m.imageNull).hasPoint(x, y);
+		}
+		static const uint64_t rowBits(const ImageMapping & m, const unsigned int y, const unsigned int xMin, const int count) {
+			uint64_t result = 0;
+			for (int i = 0; i < count; i++) {
+				if ((*m.imageNull).hasPoint(xMin + i, y)) {
+					result |= ((uint64_t) 1) << i;
+				}
+			}
+			return result;
+		}
+	};
+
+	/** Reads a bitset binary image, a whole word of a row at a time where possible. */
+	struct BitsetImage {
+		static const bool hasPoint(const ImageMapping & m, const unsigned int x, const unsigned int y) {
+			return (*m.bitsetImageNull).BitsetBinaryImage::hasPoint(x, y);
+		}
+		static const uint64_t rowBits(const ImageMapping & m, const unsigned int y, const unsigned int xMin, const int count) {
+			return (*m.bitsetImageNull).rowBits(y, xMin, count);
+		}
+	};
+
+	/** Reads a run-length encoded binary image, a run at a time where possible. */
+	struct RleImage {
+		static const bool hasPoint(const ImageMapping & m, const unsigned int x, const unsigned int y) {
+			return (*m.rleImageNull).RleBinaryImage::hasPoint(x, y);
+		}
+		static const uint64_t rowBits(const ImageMapping & m, const unsigned int y, const unsigned int xMin, const int count) {
+			return (*m.rleImageNull).rowBits(y, xMin, count);
+		}
+	};
+
+	//The step policies. Each steps a cursor through the image along a span in one way,
+	//and finds which of the next (up to 64) points are on, as the bits of a word.
+	//The cursor is stepped point by point exactly like x is, so the points found do not depend on the policy.
+
+	/** For an image that is on everywhere. */
+	struct FullStep {
+		static void start(const ImageMapping &, const int, const int, Cursor &) {
+		}
+		template <typename Image>
+		static const uint64_t fill(const ImageMapping &, Cursor &, const int count) {
+			return lowBits(count);
+		}
+		static void skip(const ImageMapping &, Cursor &, const int) {
+		}
+	};
+
+	/** For translations, which step through the columns of one row, one column at a time. */
+	struct ColumnByColumnStep {
+		static void start(const ImageMapping & m, const int x, const int y, Cursor & cursor) {
+
+			//The other policies only take points with -0.5 < u < width - 0.5. The columns are u + 0.5 rounded down,
+			//so if u + 0.5 is whole, the point that would round to column 0 is at u = -0.5 exactly, and is not taken.
+			//At the other end, a point that rounds to the column width is not taken either way.
+
+			const auto u = m.xx * x + m.xy * y + m.xc;
+			const auto v = m.yy * y + m.yc;
+			cursor.u = floor(u + 0.5);
+			cursor.firstColumn = cursor.u == u + 0.5 ? 1 : 0;
+			cursor.inside = v > -0.5 && v < m.height - 0.5;
+			cursor.fixed = cursor.inside ? (unsigned int) (v + 0.5) : 0;
+		}
+		template <typename Image>
+		static const uint64_t fill(const ImageMapping & m, Cursor & cursor, const int count) {
+			const auto column = (int) cursor.u;
+			const auto low = column > cursor.firstColumn ? column : cursor.firstColumn;
+			const auto high = column + count < (int) m.width ? column + count : (int) m.width; //Exclusive.
+			cursor.u += count;
+			return cursor.inside && low < high ?
+					Image::rowBits(m, cursor.fixed, low, high - low) << (low - column) : 0;
+		}
+		static void skip(const ImageMapping &, Cursor & cursor, const int count) {
+			cursor.u += count;
+		}
+	};
+
+	/** For axis-aligned mappings, which step through one row. */
+	struct RowStep {
+		static void start(const ImageMapping & m, const int x, const int y, Cursor & cursor) {
+			const auto v = m.yy * y + m.yc;
+			cursor.u = m.xx * x + m.xy * y + m.xc;
+			cursor.inside = v > -0.5 && v < m.height - 0.5;
+			cursor.fixed = cursor.inside ? (unsigned int) (v + 0.5) : 0;
+		}
+		template <typename Image>
+		static const uint64_t fill(const ImageMapping & m, Cursor & cursor, const int count) {
+			uint64_t result = 0;
+			for (int i = 0; i < count; i++) {
+				const auto u = cursor.u;
+				if (cursor.inside && u > -0.5 && u < m.width - 0.5 && Image::hasPoint(m, (unsigned int) (u + 0.5), cursor.fixed)) {
+					result |= ((uint64_t) 1) << i;
+				}
+				cursor.u += m.xx;
+			}
+			return result;
+		}
+		static void skip(const ImageMapping & m, Cursor & cursor, const int count) {
+			for (int i = 0; i < count; i++) {
+				cursor.u += m.xx;
+			}
+		}
+	};
+
+	/** For mappings rotated a quarter turn, which step through one column. */
+	struct ColumnStep {
+		static void start(const ImageMapping & m, const int x, const int y, Cursor & cursor) {
+			const auto u = m.xy * y + m.xc;
+			cursor.v = m.yx * x + m.yy * y + m.yc;
+			cursor.inside = u > -0.5 && u < m.width - 0.5;
+			cursor.fixed = cursor.inside ? (unsigned int) (u + 0.5) : 0;
+		}
+		template <typename Image>
+		static const uint64_t fill(const ImageMapping & m, Cursor & cursor, const int count) {
+			uint64_t result = 0;
+			for (int i = 0; i < count; i++) {
+				const auto v = cursor.v;
+				if (cursor.inside && v > -0.5 && v < m.height - 0.5 && Image::hasPoint(m, cursor.fixed, (unsigned int) (v + 0.5))) {
+					result |= ((uint64_t) 1) << i;
+				}
+				cursor.v += m.yx;
+			}
+			return result;
+		}
+		static void skip(const ImageMapping & m, Cursor & cursor, const int count) {
+			for (int i = 0; i < count; i++) {
+				cursor.v += m.yx;
+			}
+		}
+	};
+
+	/** For any other mapping, which steps in both coordinates. */
+	struct GeneralStep {
+		static void start(const ImageMapping & m, const int x, const int y, Cursor & cursor) {
+			cursor.u = m.xx * x + m.xy * y + m.xc;
+			cursor.v = m.yx * x + m.yy * y + m.yc;
+		}
+		template <typename Image>
+		static const uint64_t fill(const ImageMapping & m, Cursor & cursor, const int count) {
+
+			//Rounding half away from zero gives a point within [0; width[ exactly when -0.5 < u < width - 0.5,
+			//and for those values, adding a half and truncating rounds the same way.
+
+			uint64_t result = 0;
+			for (int i = 0; i < count; i++) {
+				const auto u = cursor.u;
+				const auto v = cursor.v;
+				if (u > -0.5 && u < m.width - 0.5 && v > -0.5 && v < m.height - 0.5
+						&& Image::hasPoint(m, (unsigned int) (u + 0.5), (unsigned int) (v + 0.5))) {
+					result |= ((uint64_t) 1) << i;
+				}
+				cursor.u += m.xx;
+				cursor.v += m.yx;
+			}
+			return result;
+		}
+		static void skip(const ImageMapping & m, Cursor & cursor, const int count) {
+			for (int i = 0; i < count; i++) {
+				cursor.u += m.xx;
+				cursor.v += m.yx;
+			}
+		}
+	};
+
+	/** The kernel of one mapping: a step policy with an image access policy, chosen once per pair. */
+	struct Side {
+		void (*start)(const ImageMapping & m, const int x, const int y, Cursor & cursor);
+		const uint64_t (*fill)(const ImageMapping & m, Cursor & cursor, const int count);
+		void (*skip)(const ImageMapping & m, Cursor & cursor, const int count);
+	};
+
+	template <typename Step, typename Image>
+	static const Side sideOf() {
+		const Side side = { &Step::start, &Step::template fill<Image>, &Step::skip };
+		return side;
+	}
+
+	template <typename Step>
+	static const Side sideOf(const ImageMapping & m) {
+		if (m.bitsetImageNull != 0) {
+			return sideOf<Step, BitsetImage>();
+		}
+		else if (m.rleImageNull != 0) {
+			return sideOf<Step, RleImage>();
+		}
+		else {
+			return sideOf<Step, AnyImage>();
+		}
+	}
+
+	static const Side sideOf(const ImageMapping & m, const TransformKind kind) {
+
+		if (m.imageNull == 0) {
+			return sideOf<FullStep, AnyImage>();
+		}
+
+		switch (kind) {
+		case TransformKind::IntegerTranslationK:
+		case TransformKind::TranslationK: {
+			return sideOf<ColumnByColumnStep>(m);
+		}
+		case TransformKind::AxisAlignedK: {
+			return sideOf<RowStep>(m);
+		}
+		case TransformKind::QuarterTurnK: {
+			return sideOf<ColumnStep>(m);
+		}
+		default: {
+			return sideOf<GeneralStep>(m);
+		}
+		}
+	}
+
+	const ImageMapping mapping1;
+	const ImageMapping mapping2;
+	const Side side1;
+	const Side side2;
+
+public:
+
+	/** The number of points in the blocks that are looked up in the occupancy pyramids. */
+	static const int blockLength = 16;
+
+	/** @param mask1 the first mask, whose binary image, occupancy pyramid and extents are used if present
+	  * @param inverse1 the transformation mapping points to the coordinate system of the first mask
+	  * @param mask2 the second mask, whose binary image, occupancy pyramid and extents are used if present
+	  * @param inverse2 the transformation mapping points to the coordinate system of the second mask
+	  */
+	AffineSpanSampler(const Mask & mask1, const Affine & inverse1,
+			const Mask & mask2, const Affine & inverse2) :
+		mapping1(mask1, inverse1), mapping2(mask2, inverse2),
+		side1(sideOf(mapping1, inverse1.kind())), side2(sideOf(mapping2, inverse2.kind())) {
+	}
+
+	/** As above, but with the kinds of the transformations already found.
+	  *
+	  * @param kind1 the kind of inverse1
+	  * @param kind2 the kind of inverse2
+	  */
+	AffineSpanSampler(const Mask & mask1, const Affine & inverse1, const TransformKind kind1,
+			const Mask & mask2, const Affine & inverse2, const TransformKind kind2) :
+		mapping1(mask1, inverse1), mapping2(mask2, inverse2),
+		side1(sideOf(mapping1, kind1)), side2(sideOf(mapping2, kind2)) {
+	}
+
+	  /** Test the points (x, y) for x in [spanMin; spanMax].
+	    *
+	    * @param y the row
+	    * @param spanMin the first point of the span
+	    * @param spanMax the last point of the span, inclusive
+	    * @return whether any point in the span is on in both images
+	    */
+	const bool operator()(const int y, const int spanMin, const int spanMax) const {
+
+		const auto & m1 = mapping1;
+		const auto & m2 = mapping2;
+
+		if (m1.imageNull == 0 && m2.imageNull == 0) { //Both are on everywhere.
+			return spanMin <= spanMax;
+		}
+
+		//Clip the span to the points that map within the extents of the points on in the images.
+
+		auto low = (double) spanMin;
+		auto high = (double) spanMax;
+		m1.clip(y, low, high);
+		m2.clip(y, low, high);
+
+		//A little slack, such that points on the border of the extents are kept.
+		const auto clippedMin = (int) ceil(low - 1e-7);
+		const auto clippedMax = (int) floor(high + 1e-7);
+
+		const auto xMin = clippedMin > spanMin ? clippedMin : spanMin;
+		const auto xMax = clippedMax < spanMax ? clippedMax : spanMax;
+
+		if (xMin > xMax) {
+			return false;
+		}
+
+		//Where a span stays in one row of an image, the whole row span is tested at once.
+		//If the other image is on everywhere and the span steps through the columns one by one, that is the answer.
+
+		if (m1.imageNull != 0 && m1.yx == 0.0) {
+			if (!m1.mayHaveOnInRow(m1.xx * xMin + m1.xy * y + m1.xc, m1.yy * y + m1.yc, xMax - xMin)) {
+				return false;
+			}
+			else if (m2.imageNull == 0 && m1.xx == 1.0) {
+				return true;
+			}
+		}
+		if (m2.imageNull != 0 && m2.yx == 0.0) {
+			if (!m2.mayHaveOnInRow(m2.xx * xMin + m2.xy * y + m2.xc, m2.yy * y + m2.yc, xMax - xMin)) {
+				return false;
+			}
+			else if (m1.imageNull == 0 && m2.xx == 1.0) {
+				return true;
+			}
+		}
+
+		//Without pyramids, the whole span is one block.
+		//With pyramids, the whole span is looked up first, since spans often miss the images entirely.
+
+		const auto usesBlocks = m1.occupancyPyramidNull != 0 || m2.occupancyPyramidNull != 0;
+		const auto length = usesBlocks ? blockLength : xMax - xMin + 1;
+
+		if (usesBlocks && xMax - xMin + 1 > blockLength) {
+
+			const auto u1 = m1.xx * xMin + m1.xy * y + m1.xc;
+			const auto v1 = m1.yx * xMin + m1.yy * y + m1.yc;
+			const auto u2 = m2.xx * xMin + m2.xy * y + m2.xc;
+			const auto v2 = m2.yx * xMin + m2.yy * y + m2.yc;
+
+			if (!m1.mayHaveOn(u1, v1, xMax - xMin) || !m2.mayHaveOn(u2, v2, xMax - xMin)) {
+				return false;
+			}
+		}
+
+		for (int blockStart = xMin; blockStart <= xMax; blockStart += length) {
+
+			const auto blockEnd = blockStart + length - 1 < xMax ? blockStart + length - 1 : xMax;
+
+			const auto u1 = m1.xx * blockStart + m1.xy * y + m1.xc;
+			const auto v1 = m1.yx * blockStart + m1.yy * y + m1.yc;
+			const auto u2 = m2.xx * blockStart + m2.xy * y + m2.xc;
+			const auto v2 = m2.yx * blockStart + m2.yy * y + m2.yc;
+
+			if (!m1.mayHaveOn(u1, v1, blockEnd - blockStart) || !m2.mayHaveOn(u2, v2, blockEnd - blockStart)) {
+				continue;
+			}
+
+			//The points of the block are found 64 at a time. Where none are on in the first image,
+			//the second image is not read, only stepped past them.
+
+			Cursor cursor1, cursor2;
+			side1.start(m1, blockStart, y, cursor1);
+			side2.start(m2, blockStart, y, cursor2);
+
+			for (int x = blockStart; x <= blockEnd; x += 64) {
+
+				const auto count = blockEnd - x + 1 < 64 ? blockEnd - x + 1 : 64;
+
+				const auto on1 = side1.fill(m1, cursor1, count);
+
+				if (on1 == 0) {
+					side2.skip(m2, cursor2, count);
+				}
+				else if ((on1 & side2.fill(m2, cursor2, count)) != 0) {
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_PIXELPERFECT_AFFINESPANSAMPLER_HPP_ */
@@ -0,0 +1,274 @@
+/* BitRowKernels.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BitRowKernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define POXELCOLL_BITROWKERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace poxelcoll {
+
+namespace {
+
+typedef BitRowKernels::Word Word;
+
+const int bitsPerWord = BitsetBinaryImage::bitsPerWord;
+
+/** The word of the second row starting at the given bit, with bits outside the row off. */
+inline Word wordAt(const Word * const row2, const int count2, const int wordIndex, const int shift) {
+
+	const Word low = (wordIndex >= 0 && wordIndex < count2) ? row2[wordIndex] : 0;
+	const Word high = (wordIndex + 1 >= 0 && wordIndex + 1 < count2) ? row2[wordIndex + 1] : 0;
+
+	if (shift == 0) {
+		return low;
+	}
+	else {
+		return (low >> shift) | (high << (bitsPerWord - shift));
+	}
+}
+
+/** The shift split into whole words and remaining bits, and the range of words of the first row
+  * for which both needed words of the second row are within it, such that no bounds are needed.
+  */
+struct Alignment {
+	int wordBase;
+	int shift;
+	int innerStart;
+	int innerEnd;
+
+	Alignment(const int count, const int count2, const int bitOffset) {
+
+		//Floored division, such that bit offsets before the row are handled like the others.
+		wordBase = bitOffset >= 0 ? bitOffset / bitsPerWord : -((-bitOffset + bitsPerWord - 1) / bitsPerWord);
+		shift = bitOffset - wordBase * bitsPerWord;
+
+		innerStart = -wordBase > 0 ? -wordBase : 0;
+		innerEnd = count2 - 1 - wordBase < count ? count2 - 1 - wordBase : count;
+		if (innerEnd < innerStart) {
+			innerStart = innerEnd = (innerStart < count ? innerStart : count);
+		}
+	}
+};
+
+//Scalar kernels, used for the ends of the rows, and for whole rows where no SIMD is available.
+
+bool anyScalar(const Word * const row1, const int from, const int to,
+		const Word * const row2, const int count2, const Alignment & alignment) {
+	for (int i = from; i < to; i++) {
+		if ((row1[i] & wordAt(row2, count2, alignment.wordBase + i, alignment.shift)) != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+unsigned long popcountScalar(const Word * const row1, const int from, const int to,
+		const Word * const row2, const int count2, const Alignment & alignment) {
+	unsigned long sum = 0;
+	for (int i = from; i < to; i++) {
+		sum += __builtin_popcountll(row1[i] & wordAt(row2, count2, alignment.wordBase + i, alignment.shift));
+	}
+	return sum;
+}
+
+//The inner kernels handle the words [innerStart, innerEnd[ and return how far they got,
+//leaving the rest to the scalar kernel.
+
+typedef bool (*AnyInner)(const Word *, const Word *, const Alignment &, int &);
+typedef unsigned long (*PopcountInner)(const Word *, const Word *, const Alignment &, int &);
+
+bool anyInnerScalar(const Word * const, const Word * const, const Alignment & alignment, int & done) {
+	done = alignment.innerStart;
+	return false;
+}
+
+unsigned long popcountInnerScalar(const Word * const, const Word * const, const Alignment & alignment, int & done) {
+	done = alignment.innerStart;
+	return 0;
+}
+
+#ifdef POXELCOLL_BITROWKERNELS_X86
+
+//NOTE: Shifting a 64-bit lane by 64 or more gives 0, so a shift of 0 needs no special handling.
+
+__attribute__((target("sse2")))
+bool anyInnerSse2(const Word * const row1, const Word * const row2, const Alignment & alignment, int & done) {
+
+	const auto shiftRight = _mm_cvtsi32_si128(alignment.shift);
+	const auto shiftLeft = _mm_cvtsi32_si128(bitsPerWord - alignment.shift);
+	const auto zero = _mm_setzero_si128();
+
+	auto i = alignment.innerStart;
+	for (; i + 2 <= alignment.innerEnd; i += 2) {
+		const auto a = _mm_loadu_si128((const __m128i*) (row1 + i));
+		const auto low = _mm_loadu_si128((const __m128i*) (row2 + alignment.wordBase + i));
+		const auto high = _mm_loadu_si128((const __m128i*) (row2 + alignment.wordBase + i + 1));
+		const auto b = _mm_or_si128(_mm_srl_epi64(low, shiftRight), _mm_sll_epi64(high, shiftLeft));
+		const auto both = _mm_and_si128(a, b);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(both, zero)) != 0xFFFF) {
+			done = i;
+			return true;
+		}
+	}
+	done = i;
+	return false;
+}
+
+__attribute__((target("sse2")))
+unsigned long popcountInnerSse2(const Word * const row1, const Word * const row2, const Alignment & alignment, int & done) {
+
+	const auto shiftRight = _mm_cvtsi32_si128(alignment.shift);
+	const auto shiftLeft = _mm_cvtsi32_si128(bitsPerWord - alignment.shift);
+
+	unsigned long sum = 0;
+	auto i = alignment.innerStart;
+	for (; i + 2 <= alignment.innerEnd; i += 2) {
+		const auto a = _mm_loadu_si128((const __m128i*) (row1 + i));
+		const auto low = _mm_loadu_si128((const __m128i*) (row2 + alignment.wordBase + i));
+		const auto high = _mm_loadu_si128((const __m128i*) (row2 + alignment.wordBase + i + 1));
+		const auto b = _mm_or_si128(_mm_srl_epi64(low, shiftRight), _mm_sll_epi64(high, shiftLeft));
+		Word both[2];
+		_mm_storeu_si128((__m128i*) both, _mm_and_si128(a, b));
+		sum += __builtin_popcountll(both[0]) + __builtin_popcountll(both[1]);
+	}
+	done = i;
+	return sum;
+}
+
+__attribute__((target("avx2")))
+bool anyInnerAvx2(const Word * const row1, const Word * const row2, const Alignment & alignment, int & done) {
+
+	const auto shiftRight = _mm_cvtsi32_si128(alignment.shift);
+	const auto shiftLeft = _mm_cvtsi32_si128(bitsPerWord - alignment.shift);
+
+	auto i = alignment.innerStart;
+	for (; i + 4 <= alignment.innerEnd; i += 4) {
+		const auto a = _mm256_loadu_si256((const __m256i*) (row1 + i));
+		const auto low = _mm256_loadu_si256((const __m256i*) (row2 + alignment.wordBase + i));
+		const auto high = _mm256_loadu_si256((const __m256i*) (row2 + alignment.wordBase + i + 1));
+		const auto b = _mm256_or_si256(_mm256_srl_epi64(low, shiftRight), _mm256_sll_epi64(high, shiftLeft));
+		if (!_mm256_testz_si256(a, b)) {
+			done = i;
+			return true;
+		}
+	}
+	done = i;
+	return false;
+}
+
+__attribute__((target("avx2,popcnt")))
+unsigned long popcountInnerAvx2(const Word * const row1, const Word * const row2, const Alignment & alignment, int & done) {
+
+	const auto shiftRight = _mm_cvtsi32_si128(alignment.shift);
+	const auto shiftLeft = _mm_cvtsi32_si128(bitsPerWord - alignment.shift);
+
+	unsigned long sum = 0;
+	auto i = alignment.innerStart;
+	for (; i + 4 <= alignment.innerEnd; i += 4) {
+		const auto a = _mm256_loadu_si256((const __m256i*) (row1 + i));
+		const auto low = _mm256_loadu_si256((const __m256i*) (row2 + alignment.wordBase + i));
+		const auto high = _mm256_loadu_si256((const __m256i*) (row2 + alignment.wordBase + i + 1));
+		const auto b = _mm256_or_si256(_mm256_srl_epi64(low, shiftRight), _mm256_sll_epi64(high, shiftLeft));
+		Word both[4];
+		_mm256_storeu_si256((__m256i*) both, _mm256_and_si256(a, b));
+		sum += __builtin_popcountll(both[0]) + __builtin_popcountll(both[1])
+				+ __builtin_popcountll(both[2]) + __builtin_popcountll(both[3]);
+	}
+	done = i;
+	return sum;
+}
+
+#endif
+
+/** The kernels chosen for this processor. */
+struct Dispatch {
+	AnyInner anyInner;
+	PopcountInner popcountInner;
+	const char* name;
+
+	Dispatch() {
+#ifdef POXELCOLL_BITROWKERNELS_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+			anyInner = anyInnerAvx2;
+			popcountInner = popcountInnerAvx2;
+			name = "avx2";
+		}
+		else if (__builtin_cpu_supports("sse2")) {
+			anyInner = anyInnerSse2;
+			popcountInner = popcountInnerSse2;
+			name = "sse2";
+		}
+		else
+#endif
+		{
+			anyInner = anyInnerScalar;
+			popcountInner = popcountInnerScalar;
+			name = "scalar";
+		}
+	}
+};
+
+const Dispatch & dispatch() {
+	static const Dispatch chosen;
+	return chosen;
+}
+
+}
+
+const bool BitRowKernels::anyShiftedAnd(const Word * const row1, const int count,
+		const Word * const row2, const int count2, const int bitOffset) {
+
+	const Alignment alignment(count, count2, bitOffset);
+
+	if (anyScalar(row1, 0, alignment.innerStart, row2, count2, alignment)) {
+		return true;
+	}
+
+	int done;
+	if (dispatch().anyInner(row1, row2, alignment, done)) {
+		return true;
+	}
+
+	return anyScalar(row1, done, count, row2, count2, alignment);
+}
+
+const unsigned long BitRowKernels::shiftedAndPopcount(const Word * const row1, const int count,
+		const Word * const row2, const int count2, const int bitOffset) {
+
+	const Alignment alignment(count, count2, bitOffset);
+
+	auto sum = popcountScalar(row1, 0, alignment.innerStart, row2, count2, alignment);
+
+	int done;
+	sum += dispatch().popcountInner(row1, row2, alignment, done);
+
+	return sum + popcountScalar(row1, done, count, row2, count2, alignment);
+}
+
+const char* BitRowKernels::instructionSet() {
+	return dispatch().name;
+}
+
+}
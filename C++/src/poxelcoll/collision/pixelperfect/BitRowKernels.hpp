@@ -0,0 +1,79 @@
+/* BitRowKernels.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_PIXELPERFECT_BITROWKERNELS_HPP_
+#define POXELCOLL_COLLISION_PIXELPERFECT_BITROWKERNELS_HPP_
+
+#include "../../binaryimage/BitsetBinaryImage.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollision
+  *
+  * Kernels for AND'ing a packed bit row with another packed bit row shifted by some number of bits.
+  *
+  * The word i of the shifted row consists of the bits of the second row starting at the bit 64*i + bitOffset,
+  * where bits outside the second row are off. The bit offset may be negative or larger than the row.
+  *
+  * '''Implementation'''
+  *
+  * The words where both needed words of the second row are within it are handled by SIMD instructions
+  * when the processor supports them, and the few words at the ends are handled one at a time.
+  * On x86, SSE2 is used as the baseline, and AVX2 is used if the processor supports it,
+  * which is detected once at run-time. On other processors, the words are handled one at a time.
+  */
+class BitRowKernels {
+
+public:
+
+	typedef BitsetBinaryImage::Word Word;
+
+	  /** Whether any bit is on in both the first row and the shifted second row.
+	    *
+	    * @param row1 the words of the first row
+	    * @param count the number of words of the first row to test
+	    * @param row2 the words of the second row
+	    * @param count2 the number of words in the second row
+	    * @param bitOffset the bit of the second row that is aligned with the first bit of the first row
+	    * @return whether any bit is on in both
+	    */
+	static const bool anyShiftedAnd(const Word * const row1, const int count,
+			const Word * const row2, const int count2, const int bitOffset);
+
+	  /** The number of bits that are on in both the first row and the shifted second row.
+	    *
+	    * @param row1 the words of the first row
+	    * @param count the number of words of the first row to test
+	    * @param row2 the words of the second row
+	    * @param count2 the number of words in the second row
+	    * @param bitOffset the bit of the second row that is aligned with the first bit of the first row
+	    * @return the number of bits on in both
+	    */
+	static const unsigned long shiftedAndPopcount(const Word * const row1, const int count,
+			const Word * const row2, const int count2, const int bitOffset);
+
+	/** @return the name of the instruction set the kernels use on this processor, ie. "avx2", "sse2" or "scalar" */
+	static const char* instructionSet();
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_PIXELPERFECT_BITROWKERNELS_HPP_ */
@@ -0,0 +1,141 @@
+/* BitmaskOverlap.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_PIXELPERFECT_BITMASKOVERLAP_HPP_
+#define POXELCOLL_COLLISION_PIXELPERFECT_BITMASKOVERLAP_HPP_
+
+#include "BitRowKernels.hpp"
+#include "../../binaryimage/BitsetBinaryImage.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollision
+  *
+  * The bitmask overlap tests two bitset binary images that are only translated relative to each other,
+  * by an integer number of pixels.
+  *
+  * '''Method'''
+  *
+  * For every row where the images overlap, the packed words of the first image are AND'ed with
+  * the packed words of the second image, shifted into the same alignment. This tests 64 pixels at a time,
+  * or more where the bit row kernels can use SIMD instructions.
+  * The test stops at the first word with a pixel that is on in both images,
+  * while the area counts the pixels that are on in both.
+  */
+class BitmaskOverlap {
+
+private:
+
+	/** The overlapping rows and words of the two images. */
+	struct Overlap {
+		int yStart;
+		int yEnd;
+		int wordStart;
+		int wordCount;
+
+		Overlap(const BitsetBinaryImage & image1, const BitsetBinaryImage & image2,
+				const int offsetX, const int offsetY) {
+
+			const int width1 = image1.width();
+			const int height1 = image1.height();
+			const int width2 = image2.width();
+			const int height2 = image2.height();
+
+			yStart = offsetY > 0 ? offsetY : 0;
+			yEnd = offsetY + height2 < height1 ? offsetY + height2 : height1;
+
+			const auto xStart = offsetX > 0 ? offsetX : 0;
+			const auto xEnd = offsetX + width2 < width1 ? offsetX + width2 : width1;
+
+			if (yStart >= yEnd || xStart >= xEnd) { //No overlap.
+				yEnd = yStart;
+				wordStart = 0;
+				wordCount = 0;
+			}
+			else {
+				const int bits = BitsetBinaryImage::bitsPerWord;
+				wordStart = xStart / bits;
+				wordCount = (xEnd - 1) / bits - wordStart + 1;
+			}
+		}
+	};
+
+public:
+
+	  /** Test whether any pixel is on in both images, when the second image is placed with its pixel (0, 0)
+	    * at the pixel (offsetX, offsetY) of the first image.
+	    *
+	    * @param image1 first image
+	    * @param image2 second image
+	    * @param offsetX horizontal position of the second image relative to the first
+	    * @param offsetY vertical position of the second image relative to the first
+	    * @return whether the images overlap in a pixel that is on in both
+	    */
+	static const bool overlaps(const BitsetBinaryImage & image1, const BitsetBinaryImage & image2,
+			const int offsetX, const int offsetY) {
+
+		const Overlap overlap(image1, image2, offsetX, offsetY);
+
+		//The bits after the last pixel of each row are off, and so are the bits outside the second row,
+		//so the words need not be masked to the overlap.
+
+		for (int y = overlap.yStart; y < overlap.yEnd; y++) {
+			if (BitRowKernels::anyShiftedAnd(
+					image1.row(y) + overlap.wordStart, overlap.wordCount,
+					image2.row(y - offsetY), image2.wordsPerRow(),
+					overlap.wordStart * BitsetBinaryImage::bitsPerWord - offsetX)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	  /** The number of pixels that are on in both images, when the second image is placed with its pixel (0, 0)
+	    * at the pixel (offsetX, offsetY) of the first image.
+	    *
+	    * @param image1 first image
+	    * @param image2 second image
+	    * @param offsetX horizontal position of the second image relative to the first
+	    * @param offsetY vertical position of the second image relative to the first
+	    * @return the area of the overlap in pixels
+	    */
+	static const unsigned long overlapArea(const BitsetBinaryImage & image1, const BitsetBinaryImage & image2,
+			const int offsetX, const int offsetY) {
+
+		const Overlap overlap(image1, image2, offsetX, offsetY);
+
+		unsigned long area = 0;
+
+		for (int y = overlap.yStart; y < overlap.yEnd; y++) {
+			area += BitRowKernels::shiftedAndPopcount(
+					image1.row(y) + overlap.wordStart, overlap.wordCount,
+					image2.row(y - offsetY), image2.wordsPerRow(),
+					overlap.wordStart * BitsetBinaryImage::bitsPerWord - offsetX);
+		}
+
+		return area;
+	}
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_PIXELPERFECT_BITMASKOVERLAP_HPP_ */
@@ -0,0 +1,203 @@
+/* ScanlineRasterizer.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_COLLISION_PIXELPERFECT_SCANLINERASTERIZER_HPP_
+#define POXELCOLL_COLLISION_PIXELPERFECT_SCANLINERASTERIZER_HPP_
+
+#include <math.h>
+
+#include "../../DataTypes.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollcollision
+  *
+  * The scanline rasterizer finds the integer points near a convex polygon, row by row, as horizontal spans.
+  *
+  * '''Method'''
+  *
+  * The vertices are split at the top-most and bottom-most vertex into two chains, both monotone in y.
+  * The rows are visited from the top to the bottom, and each chain is walked along with the rows,
+  * such that every edge is visited a constant number of times.
+  *
+  * The spans are conservative: a row y gets the span of all integer x that lie within the margin
+  * of some point in the polygon whose y-coordinate lies within the margin of y.
+  * In other words, the integer points of the polygon grown by a square with the margin as half its side-length.
+  *
+  * No memory is allocated, and the spans are given to a span function as they are found,
+  * such that the search can stop at the first span for which the span function holds.
+  */
+class ScanlineRasterizer {
+
+private:
+
+	/** One of the two y-monotone chains of the polygon, walked from the top vertex to the bottom vertex.
+	  *
+	  * The chain is given by a start vertex, an end vertex, and the direction of the vertex indices.
+	  */
+	class Chain {
+
+	private:
+		const P * const points;
+		const unsigned int size;
+		const int direction;
+		const unsigned int end;
+		unsigned int current; //The start vertex of the current edge.
+
+		const unsigned int next(const unsigned int index) const {
+			return (index + size + direction) % size;
+		}
+
+		/** The x-coordinate of the edge from "current" at the given y, which must lie on the edge. */
+		const double xAt(const unsigned int from, const double y) const {
+
+			const auto a = points[from];
+			const auto b = points[next(from)];
+			const auto dy = b.gY() - a.gY();
+
+			if (dy <= 0.0) { //Horizontal edge, which is only found at the ends of the chain.
+				return a.gX();
+			}
+			else {
+				const auto t = (y - a.gY()) / dy;
+				return a.gX() + t * (b.gX() - a.gX());
+			}
+		}
+
+	public:
+		Chain(const P * const aPoints, const unsigned int aSize, const int aDirection,
+				const unsigned int start, const unsigned int aEnd) :
+			points(aPoints), size(aSize), direction(aDirection), end(aEnd), current(start) {
+		}
+
+		/** Find the x-extent of the chain between y-coordinates yMin and yMax, both clamped to the chain.
+		  *
+		  * Calls must be given with non-decreasing yMin.
+		  */
+		void extent(const double yMin, const double yMax, double & xMin, double & xMax) {
+
+			//Skip the edges that end above yMin.
+
+			while (current != end && points[next(current)].gY() < yMin) {
+				current = next(current);
+			}
+
+			const auto include = [&xMin, &xMax](const double x) {
+				xMin = x < xMin ? x : xMin;
+				xMax = x > xMax ? x : xMax;
+			};
+
+			if (current == end) { //Only the bottom vertex is left.
+				include(points[end].gX());
+				return;
+			}
+
+			const auto & top = points[current];
+			include(yMin <= top.gY() ? top.gX() : xAt(current, yMin));
+
+			//Include the vertices within the band, and the crossing at yMax.
+
+			auto index = current;
+			while (index != end) {
+				const auto nextIndex = next(index);
+				const auto & nextPoint = points[nextIndex];
+				if (nextPoint.gY() <= yMax) {
+					include(nextPoint.gX());
+					index = nextIndex;
+				}
+				else {
+					include(xAt(index, yMax));
+					break;
+				}
+			}
+		}
+	};
+
+public:
+
+	  /** Visit the conservative spans of a non-empty convex polygon, from the top row to the bottom row,
+	    * until the span function holds for a span.
+	    *
+	    * The points may be given in either orientation, and the polygon may be degenerate (a point or a line segment).
+	    *
+	    * @param points the vertices of the convex polygon
+	    * @param size the number of vertices, strictly positive
+	    * @param margin the non-negative distance the polygon is grown by
+	    * @param spanFunction called with (y, xMin, xMax) for every non-empty span, where xMin and xMax are inclusive,
+	    *                     returning whether the search should stop
+	    * @return whether the span function held for any span
+	    */
+	template <typename SpanFunction>
+	static const bool forEachSpan(const P * const points, const unsigned int size, const double margin,
+			const SpanFunction & spanFunction) {
+
+		if (size == 0) {
+			return false;
+		}
+
+		//Find the top and bottom vertices.
+
+		unsigned int top = 0;
+		unsigned int bottom = 0;
+		for (unsigned int i = 1; i < size; i++) {
+			if (points[i].gY() < points[top].gY()) {
+				top = i;
+			}
+			if (points[i].gY() > points[bottom].gY()) {
+				bottom = i;
+			}
+		}
+
+		const auto yTop = points[top].gY();
+		const auto yBottom = points[bottom].gY();
+
+		Chain forward(points, size, 1, top, bottom);
+		Chain backward(points, size, -1, top, bottom);
+
+		const auto rowStart = (int) ceil(yTop - margin);
+		const auto rowEnd = (int) floor(yBottom + margin);
+
+		for (int y = rowStart; y <= rowEnd; y++) {
+
+			const auto bandMin = fmax(y - margin, yTop);
+			const auto bandMax = fmin(y + margin, yBottom);
+
+			auto xMin = HUGE_VAL;
+			auto xMax = -HUGE_VAL;
+
+			forward.extent(bandMin, bandMax, xMin, xMax);
+			backward.extent(bandMin, bandMax, xMin, xMax);
+
+			const auto spanMin = (int) ceil(xMin - margin);
+			const auto spanMax = (int) floor(xMax + margin);
+
+			if (spanMin <= spanMax && spanFunction(y, spanMin, spanMax)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+};
+
+}
+
+#endif /* POXELCOLL_COLLISION_PIXELPERFECT_SCANLINERASTERIZER_HPP_ */
@@ -41,8 +41,10 @@
   * geometric stability, but not numerical stability.
   *
   * The collision package is the main package that supports the actual collision detection,
-  * and uses the other packages to do this. As of version 0.1, the only collision phase supported
+  * and uses the other packages to do this. The main collision phase supported
   * is the narrow phase, which is basically collision detection between pairs of objects.
+  * The broad phase, which finds the pairs of objects that may collide, is supported through simple
+  * bounding box based methods.
   * Over-approximations such as axis-aligned bounding boxes and polygon intersection is
   * used to increase the efficiency of this phase and quickly prune those collisions that cannot happen.
   * The other part of this package is the part that deals with pixel-perfect collision detection.
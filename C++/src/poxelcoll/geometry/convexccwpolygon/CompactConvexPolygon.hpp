@@ -0,0 +1,287 @@
+/* CompactConvexPolygon.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_COMPACTCONVEXPOLYGON_HPP_
+#define POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_COMPACTCONVEXPOLYGON_HPP_
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
+#include "ConvexClipper.hpp"
+#include "DataTypes.hpp"
+#include "../../DataTypes.hpp"
+#include "../matrix/Affine.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollgeometryconvexccwpolygon
+ *
+ * A convex counter-clockwise polygon as a plain value, with its points stored inline.
+ *
+ * Unlike ConvexCCWPolygon, it has no virtual methods and is not reference counted, so it is trivially copyable,
+ * and it keeps its points and its axis-aligned bounding box next to its kind, where one cache line reaches them.
+ * It is meant for the hot paths of collision detection, which keep the transformed hulls of collision objects this way.
+ *
+ * It holds at most Capacity points, and creating one from more points fails.
+ * The kind follows from the number of points: 0 for empty, 1 for a point, 2 for a line and 3 or more for a polygon.
+ * The polygon may be degenerate, such as an intersection of polygons that only touch.
+ */
+template <unsigned int Capacity>
+class CompactConvexPolygon {
+
+public:
+
+	/** The largest number of points the polygon may have. */
+	static const unsigned int capacity = Capacity;
+
+private:
+
+	typedef typename std::aligned_storage<sizeof(P), std::alignment_of<P>::value>::type Slot;
+
+	ConvexCCWType myType;
+	unsigned int mySize;
+	double myXMin, myYMin, myXMax, myYMax;
+	Slot slots[Capacity];
+
+	P * mutablePoints() {
+		return reinterpret_cast<P*>(slots);
+	}
+
+	/** Sets the kind and the bounding box from the points, which must already be written. */
+	void finish(const unsigned int size) {
+
+		mySize = size;
+		myType = size == 0 ? ConvexCCWType::EmptyT :
+				size == 1 ? ConvexCCWType::PointT :
+				size == 2 ? ConvexCCWType::LineT :
+				ConvexCCWType::PolygonT;
+
+		myXMin = 0.0;
+		myYMin = 0.0;
+		myXMax = 0.0;
+		myYMax = 0.0;
+
+		if (size != 0) {
+
+			const auto points = this->points();
+
+			myXMin = points[0].gX();
+			myYMin = points[0].gY();
+			myXMax = myXMin;
+			myYMax = myYMin;
+
+			for (unsigned int i = 1; i < size; i++) {
+				myXMin = std::min(myXMin, points[i].gX());
+				myYMin = std::min(myYMin, points[i].gY());
+				myXMax = std::max(myXMax, points[i].gX());
+				myYMax = std::max(myYMax, points[i].gY());
+			}
+		}
+	}
+
+public:
+
+	/** Creates the empty polygon. */
+	CompactConvexPolygon() : myType(ConvexCCWType::EmptyT), mySize(0), myXMin(0.0), myYMin(0.0), myXMax(0.0), myYMax(0.0) {
+	}
+
+	/** Creates a polygon from its points, if they fit.
+	 *
+	 * @param points the points, counter-clockwise if they are 3 or more
+	 * @param size the number of points
+	 * @param result set to the polygon if the points fit, else left as it is
+	 * @return whether the points fit, ie. whether size is at most the capacity
+	 */
+	static const bool fromPoints(const P * const points, const unsigned int size, CompactConvexPolygon & result) {
+
+		if (size > Capacity) {
+			return false;
+		}
+
+		const auto resultPoints = result.mutablePoints();
+		for (unsigned int i = 0; i < size; i++) {
+			new (resultPoints + i) P(points[i]);
+		}
+		result.finish(size);
+
+		return true;
+	}
+
+	/** Creates a polygon from points transformed by an affine transformation, which keeps the polygon convex, if they fit.
+	 *
+	 * A transformation that mirrors turns counter-clockwise into clockwise, so then the points are reversed.
+	 *
+	 * @param points the points before the transformation, counter-clockwise if they are 3 or more
+	 * @param size the number of points
+	 * @param transformation the transformation
+	 * @param result set to the transformed polygon if the points fit, else left as it is
+	 * @return whether the points fit, ie. whether size is at most the capacity
+	 */
+	static const bool fromTransformedPoints(const P * const points, const unsigned int size, const Affine & transformation,
+			CompactConvexPolygon & result) {
+
+		if (size > Capacity) {
+			return false;
+		}
+
+		const auto resultPoints = result.mutablePoints();
+		const auto mirrors = transformation.determinant() < 0.0;
+
+		for (unsigned int i = 0; i < size; i++) {
+			new (resultPoints + i) P(transformation.transform(points[mirrors ? size - 1 - i : i]));
+		}
+		result.finish(size);
+
+		return true;
+	}
+
+	/** Creates a polygon from points that are already transformed, given as a structure of arrays, if they fit.
+	 * This is the same as fromTransformedPoints, for points transformed in a batch, see TransformArena.
+	 *
+	 * @param xs the x-coordinates of the transformed points
+	 * @param ys the y-coordinates of the transformed points
+	 * @param size the number of points
+	 * @param transformation the transformation the points were transformed by, which tells whether they must be reversed
+	 * @param result set to the transformed polygon if the points fit, else left as it is
+	 * @return whether the points fit, ie. whether size is at most the capacity
+	 */
+	static const bool fromTransformedCoordinates(const double * const xs, const double * const ys, const unsigned int size,
+			const Affine & transformation, CompactConvexPolygon & result) {
+
+		if (size > Capacity) {
+			return false;
+		}
+
+		const auto resultPoints = result.mutablePoints();
+		const auto mirrors = transformation.determinant() < 0.0;
+
+		for (unsigned int i = 0; i < size; i++) {
+			const auto j = mirrors ? size - 1 - i : i;
+			new (resultPoints + i) P(xs[j], ys[j]);
+		}
+		result.finish(size);
+
+		return true;
+	}
+
+	const ConvexCCWType getType() const {
+		return myType;
+	}
+
+	const unsigned int size() const {
+		return mySize;
+	}
+
+	/** The points, of which there are size(). */
+	const P * points() const {
+		return reinterpret_cast<const P*>(slots);
+	}
+
+	/** The axis-aligned bounding box of the points.
+	 *
+	 * NOTE: Only valid if the polygon is not empty.
+	 */
+	const BoundingBox boundingBox() const {
+		return BoundingBox(P(myXMin, myYMin), P(myXMax, myYMax));
+	}
+
+	/** Whether the axis-aligned bounding boxes of this and another non-empty polygon intersect, including if they only touch. */
+	template <unsigned int ThatCapacity>
+	const bool boundsIntersect(const CompactConvexPolygon<ThatCapacity> & that) const {
+		return myXMin <= that.myXMax && that.myXMin <= myXMax && myYMin <= that.myYMax && that.myYMin <= myYMax;
+	}
+
+	/** Whether the axis-aligned bounding box of this non-empty polygon intersects a bounding box, including if they only touch. */
+	const bool boundsIntersect(const BoundingBox & that) const {
+		return myXMin <= that.pMax.gX() && that.pMin.gX() <= myXMax && myYMin <= that.pMax.gY() && that.pMin.gY() <= myYMax;
+	}
+
+	/** Translate the points by a vector represented as a point.
+	 *
+	 * @param p the vector to translate with
+	 * @return the translated polygon
+	 */
+	const CompactConvexPolygon translate(const P & p) const {
+
+		//Only the points in use are copied, not the whole storage.
+
+		CompactConvexPolygon result;
+
+		const auto points = this->points();
+		const auto resultPoints = result.mutablePoints();
+		for (unsigned int i = 0; i < mySize; i++) {
+			new (resultPoints + i) P(points[i].plus(p));
+		}
+
+		result.myType = myType;
+		result.mySize = mySize;
+		result.myXMin = myXMin + p.gX();
+		result.myYMin = myYMin + p.gY();
+		result.myXMax = myXMax + p.gX();
+		result.myYMax = myYMax + p.gY();
+
+		return result;
+	}
+
+	/** Transform the points by an affine transformation, which keeps the polygon convex, see fromTransformedPoints.
+	 *
+	 * @param transformation the transformation
+	 * @return the transformed polygon
+	 */
+	const CompactConvexPolygon transform(const Affine & transformation) const {
+
+		CompactConvexPolygon result;
+		fromTransformedPoints(points(), mySize, transformation, result);
+
+		return result;
+	}
+
+	/** Finds the intersection of this and another polygon, see ConvexClipper.
+	 *
+	 * @param that the other polygon
+	 * @param result set to the intersection if it is found, else left as it is
+	 * @return whether the intersection was found, which is not the case if neither polygon is a polygon,
+	 *         or if the intersection may have more points than the result can hold
+	 */
+	template <unsigned int ThatCapacity, unsigned int ResultCapacity>
+	const bool intersection(const CompactConvexPolygon<ThatCapacity> & that, CompactConvexPolygon<ResultCapacity> & result) const {
+
+		if (mySize == 0 || that.size() == 0) {
+			result = CompactConvexPolygon<ResultCapacity>();
+			return true;
+		}
+
+		ConvexClipper::Buffer buffer;
+		const P * intersectionPoints = 0;
+		unsigned int intersectionSize = 0;
+
+		return ConvexClipper::intersect(points(), mySize, that.points(), that.size(), buffer, intersectionPoints, intersectionSize)
+				&& CompactConvexPolygon<ResultCapacity>::fromPoints(intersectionPoints, intersectionSize, result);
+	}
+
+	template <unsigned int OtherCapacity>
+	friend class CompactConvexPolygon;
+};
+
+}
+
+#endif /* POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_COMPACTCONVEXPOLYGON_HPP_ */
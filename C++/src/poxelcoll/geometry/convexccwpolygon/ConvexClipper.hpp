@@ -0,0 +1,187 @@
+/* ConvexClipper.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_CONVEXCLIPPER_HPP_
+#define POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_CONVEXCLIPPER_HPP_
+
+#include <new>
+#include <type_traits>
+
+#include "../../DataTypes.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollgeometryconvexccwpolygon
+ *
+ * Finds the intersection of two convex polygons without allocating any memory,
+ * by clipping one polygon by each edge of the other (the Sutherland-Hodgman algorithm).
+ *
+ * The vertices are written into a buffer of fixed capacity that the caller keeps on its stack.
+ * Clipping by an edge adds at most one vertex, so the intersection has at most as many vertices as
+ * the two polygons together. Polygons with more vertices than the buffer can hold are not clipped,
+ * and the caller must then fall back to PolygonIntersection.
+ *
+ * The polygons are given as their points, 1 for a point, 2 for a line and 3 or more for a polygon,
+ * and at least one of them must be a polygon. The points on the border of a polygon are inside it,
+ * so polygons that only touch have a degenerate intersection, which may contain repeated points.
+ * That is fine for the scanline rasterizer, which accepts degenerate polygons.
+ */
+class ConvexClipper {
+
+public:
+
+	/** The largest number of vertices the intersection may have. */
+	static const unsigned int capacity = 128;
+
+	/** Room for the vertices of an intersection, meant to be kept on the stack of the caller.
+	 */
+	class Buffer {
+
+	private:
+
+		typedef std::aligned_storage<sizeof(P), std::alignment_of<P>::value>::type Slot;
+
+		Slot slots[2][capacity];
+
+		P * points(const unsigned int index) {
+			return reinterpret_cast<P*>(slots[index]);
+		}
+
+		friend class ConvexClipper;
+	};
+
+private:
+
+	/** @return whether all the points lie in the half-plane to the left of the directed line through a and b, or on the line */
+	static const bool allInside(const P * const points, const unsigned int size, const P & a, const P & b) {
+
+		const auto edge = b.minus(a);
+
+		for (unsigned int i = 0; i < size; i++) {
+			if (edge.cross(points[i].minus(a)) < 0.0) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/** Clips a convex polygon by the half-plane to the left of the directed line through a and b.
+	 *
+	 * @return the number of vertices written, or capacity + 1 if they do not fit
+	 */
+	static const unsigned int clipByEdge(const P * const input, const unsigned int inputSize,
+			const P & a, const P & b, P * const output) {
+
+		const auto edge = b.minus(a);
+
+		unsigned int outputSize = 0;
+
+		for (unsigned int i = 0; i < inputSize; i++) {
+
+			const auto & p = input[i];
+			const auto & q = input[i + 1 < inputSize ? i + 1 : 0];
+
+			const auto sideP = edge.cross(p.minus(a));
+			const auto sideQ = edge.cross(q.minus(a));
+
+			if (sideP >= 0.0) {
+				if (outputSize == capacity) {
+					return capacity + 1;
+				}
+				new (output + outputSize++) P(p);
+			}
+
+			if ((sideP > 0.0 && sideQ < 0.0) || (sideP < 0.0 && sideQ > 0.0)) {
+				if (outputSize == capacity) {
+					return capacity + 1;
+				}
+				const auto t = sideP / (sideP - sideQ);
+				new (output + outputSize++) P(p.plus(q.minus(p).multi(t)));
+			}
+		}
+
+		return outputSize;
+	}
+
+public:
+
+	/** Finds the intersection of two convex polygons, each either counter-clockwise or degenerate.
+	 *
+	 * @param points1 the points of the first polygon
+	 * @param size1 the strictly positive number of points of the first polygon
+	 * @param points2 the points of the second polygon
+	 * @param size2 the strictly positive number of points of the second polygon
+	 * @param buffer the buffer the intersection is written into
+	 * @param result set to the points of the intersection, which lie in the buffer
+	 * @param resultSize set to the number of points of the intersection, which is 0 if it is empty
+	 * @return whether the intersection was found, which is not the case if neither polygon is a polygon,
+	 *         or if the intersection may have more than capacity vertices
+	 */
+	static const bool intersect(const P * const points1, const unsigned int size1,
+			const P * const points2, const unsigned int size2,
+			Buffer & buffer, const P * & result, unsigned int & resultSize) {
+
+		if (size2 < 3) {
+			return size1 >= 3 && intersect(points2, size2, points1, size1, buffer, result, resultSize);
+		}
+		else if (size1 + size2 > capacity) {
+			return false;
+		}
+
+		//The first polygon is clipped by each edge of the second, going back and forth between the two halves of the buffer.
+		//Most edges of the second polygon do not cut the first polygon, and those are skipped without copying.
+
+		const P * input = points1;
+		auto inputSize = size1;
+		unsigned int half = 0;
+
+		for (unsigned int i = 0; i < size2 && inputSize != 0; i++) {
+
+			const auto & a = points2[i];
+			const auto & b = points2[i + 1 < size2 ? i + 1 : 0];
+
+			if (allInside(input, inputSize, a, b)) {
+				continue;
+			}
+
+			const auto output = buffer.points(half);
+			const auto outputSize = clipByEdge(input, inputSize, a, b, output);
+			half = 1 - half;
+
+			if (outputSize > capacity) {
+				return false;
+			}
+
+			input = output;
+			inputSize = outputSize;
+		}
+
+		result = input;
+		resultSize = inputSize;
+
+		return true;
+	}
+};
+
+}
+
+#endif /* POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_CONVEXCLIPPER_HPP_ */
@@ -50,9 +50,7 @@ public:
 	const static std::shared_ptr<const poxelcoll::ConvexCCWPolygon> calculateConvexHull(
 			std::vector<P> & points) {
 
-		//    //TODO: Extension: Consider supporting a mask or similar.
-		//    //TODO: Optimization: Simple optimization for mask: extract the upper and lower point for each column, if any.
-		//    //Then sort that.
+		//    //NOTE: Masks do not use this, see MaskHull, which only considers the upper and lower point for each column.
 		//    //Implement simple monotone chain. Fair time complexity (O(n log n) worst case),
 		//    //but is not optimal, especially considering the domain (binary images),
 		//    //which tend to be dense.
@@ -0,0 +1,289 @@
+/* ConvexSearch.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_CONVEXSEARCH_HPP_
+#define POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_CONVEXSEARCH_HPP_
+
+#include <algorithm>
+
+#include "../../DataTypes.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollgeometryconvexccwpolygon
+ *
+ * Queries on convex counter-clockwise polygons that take logarithmic time in the number of points,
+ * by binary search over the points.
+ *
+ * The polygons are given as their points, of which there must be at least 3, without duplicated points nor collinearity,
+ * such as the points of a Polygon or a CompactConvexPolygon that is a polygon.
+ * The points on the border of a polygon are inside it.
+ */
+class ConvexSearch {
+
+private:
+
+	static const unsigned int next(const unsigned int i, const unsigned int size) {
+		return i + 1 < size ? i + 1 : 0;
+	}
+
+	static const unsigned int previous(const unsigned int i, const unsigned int size) {
+		return i > 0 ? i - 1 : size - 1;
+	}
+
+	/** Where the line through p along a direction crosses the line through a and b, as a multiple of the direction,
+	 * found from cross products rather than from the crossing point, so that an exact crossing stays exact.
+	 * The lines must not be parallel.
+	 */
+	static const double crossingAlong(const P & p, const P & direction, const P & a, const P & b) {
+		const auto edge = b.minus(a);
+		return edge.cross(a.minus(p)) / edge.cross(direction);
+	}
+
+	/** Where a point on the line through p along a direction lies, as a multiple of the direction. */
+	static const double along(const P & p, const P & direction, const P & point) {
+		return point.minus(p).dot(direction) / direction.dot(direction);
+	}
+
+public:
+
+	/** Finds a point of the polygon that lies farthest in a direction.
+	 *
+	 * The values of a linear function rise from the lowest point to the highest point counter-clockwise,
+	 * and fall from the highest point to the lowest, so the edges along which the function rises form a
+	 * single run, which is found by bisection.
+	 *
+	 * @param points the points of the polygon
+	 * @param size the number of points, at least 3
+	 * @param direction the direction, which need not be normalized
+	 * @return the index of a point with the largest dot product with the direction
+	 */
+	static const unsigned int extremeIndex(const P * const points, const unsigned int size, const P & direction) {
+
+		const auto rises = [points, size, &direction](const unsigned int i) {
+			return points[next(i, size)].minus(points[i]).dot(direction) > 0.0;
+		};
+		const auto isExtreme = [points, size, &direction, &rises](const unsigned int i) {
+			return !rises(i) && points[previous(i, size)].minus(points[i]).dot(direction) <= 0.0;
+		};
+
+		if (isExtreme(0)) {
+			return 0;
+		}
+
+		//Invariant: the extreme point lies strictly after a and at or before b, where b is size, ie. the first point again.
+
+		unsigned int a = 0;
+		unsigned int b = size;
+		auto risesA = rises(0);
+
+		while (b - a > 1) {
+
+			const auto c = (a + b) / 2;
+
+			if (isExtreme(c)) {
+				return c;
+			}
+
+			const auto risesC = rises(c);
+			const auto cAboveA = points[c].minus(points[a]).dot(direction) > 0.0;
+
+			//The point c is before the extreme point if the function rises there, and is not back on the rising run of a
+			//after having passed the extreme point, which would put it below a.
+
+			const auto cBeforeExtreme = risesA ? (risesC && cAboveA) : (risesC || !cAboveA);
+
+			if (cBeforeExtreme) {
+				a = c;
+				risesA = risesC;
+			}
+			else {
+				b = c;
+			}
+		}
+
+		return b == size ? 0 : b;
+	}
+
+	/** Whether a point lies inside the polygon, including on its border.
+	 *
+	 * The polygon is split into a fan of triangles from the first point, and the triangle the point lies in
+	 * the angle of is found by bisection.
+	 *
+	 * @param points the points of the polygon
+	 * @param size the number of points, at least 3
+	 * @param p the point
+	 * @return whether the point lies inside the polygon
+	 */
+	static const bool contains(const P * const points, const unsigned int size, const P & p) {
+
+		const auto & origin = points[0];
+		const auto toP = p.minus(origin);
+
+		if (points[1].minus(origin).cross(toP) < 0.0 || points[size - 1].minus(origin).cross(toP) > 0.0) {
+			return false;
+		}
+
+		//Find the last point i in 1 .. size - 2 such that p lies to the left of the ray from the origin through i.
+
+		unsigned int low = 1;
+		unsigned int high = size - 2;
+
+		while (low < high) {
+			const auto middle = (low + high + 1) / 2;
+			if (points[middle].minus(origin).cross(toP) >= 0.0) {
+				low = middle;
+			}
+			else {
+				high = middle - 1;
+			}
+		}
+
+		return points[low + 1].minus(points[low]).cross(p.minus(points[low])) >= 0.0;
+	}
+
+	/** Clips a line segment to the polygon.
+	 *
+	 * The line through the segment crosses the border of the polygon at most twice, once on the run of points
+	 * from the lowest to the highest point relative to the line, and once on the run back, and the function that gives
+	 * the side of the line a point lies on is monotone along each run, so each crossing is found by bisection.
+	 *
+	 * @param points the points of the polygon
+	 * @param size the number of points, at least 3
+	 * @param p1 the first end of the segment
+	 * @param p2 the second end of the segment
+	 * @param result1 set to the first end of the clipped segment if it is not empty, else left as it is
+	 * @param result2 set to the second end of the clipped segment if it is not empty, else left as it is,
+	 *                and which is the same as the first end if the clipped segment is a point
+	 * @return whether the clipped segment is not empty
+	 */
+	static const bool clipSegment(const P * const points, const unsigned int size, const P & p1, const P & p2,
+			P & result1, P & result2) {
+
+		const auto direction = p2.minus(p1);
+
+		if (direction.gX() == 0.0 && direction.gY() == 0.0) {
+			if (contains(points, size, p1)) {
+				result1 = p1;
+				result2 = p1;
+				return true;
+			}
+			else {
+				return false;
+			}
+		}
+
+		//The side of the line a point lies on, positive to the left.
+
+		const P normal(-direction.gY(), direction.gX());
+		const auto side = [points, &p1, &normal](const unsigned int i) {
+			return points[i].minus(p1).dot(normal);
+		};
+
+		const auto highest = extremeIndex(points, size, normal);
+		const auto lowest = extremeIndex(points, size, P(-normal.gX(), -normal.gY()));
+
+		const auto sideHighest = side(highest);
+		const auto sideLowest = side(lowest);
+
+		if (sideHighest < 0.0 || sideLowest > 0.0) {
+			return false;
+		}
+
+		//Where the line enters and leaves the polygon, as multiples of the direction from the first end.
+
+		double t1 = 0.0;
+		double t2 = 0.0;
+
+		if (sideHighest == 0.0 || sideLowest == 0.0) {
+
+			//The line only touches the polygon, in a point or along an edge.
+
+			const auto touching = sideHighest == 0.0 ? highest : lowest;
+			const auto before = previous(touching, size);
+			const auto after = next(touching, size);
+
+			t1 = along(p1, direction, side(before) == 0.0 ? points[before] : points[touching]);
+			t2 = along(p1, direction, side(after) == 0.0 ? points[after] : points[touching]);
+		}
+		else {
+
+			//Find the first point at or above the line on the rising run, and the first point below it on the falling run.
+
+			const auto risingLength = (highest + size - lowest) % size;
+			const auto fallingLength = (lowest + size - highest) % size;
+
+			unsigned int low = 1;
+			unsigned int high = risingLength;
+			while (low < high) {
+				const auto middle = (low + high) / 2;
+				if (side((lowest + middle) % size) >= 0.0) {
+					high = middle;
+				}
+				else {
+					low = middle + 1;
+				}
+			}
+			const auto rising = (lowest + low) % size;
+			const auto beforeRising = previous(rising, size);
+			t1 = side(rising) == 0.0 ? along(p1, direction, points[rising]) :
+					crossingAlong(p1, direction, points[beforeRising], points[rising]);
+
+			low = 1;
+			high = fallingLength;
+			while (low < high) {
+				const auto middle = (low + high) / 2;
+				if (side((highest + middle) % size) < 0.0) {
+					high = middle;
+				}
+				else {
+					low = middle + 1;
+				}
+			}
+			const auto falling = (highest + low) % size;
+			const auto beforeFalling = previous(falling, size);
+			t2 = side(beforeFalling) == 0.0 ? along(p1, direction, points[beforeFalling]) :
+					crossingAlong(p1, direction, points[beforeFalling], points[falling]);
+		}
+
+		//Clip the segment to the part of the line between the crossings.
+
+		const auto tMin = std::max(0.0, std::min(t1, t2));
+		const auto tMax = std::min(1.0, std::max(t1, t2));
+
+		if (tMin > tMax) {
+			return false;
+		}
+
+		const auto pointAt = [&p1, &p2, &direction](const double t) {
+			return t == 0.0 ? p1 : t == 1.0 ? p2 : p1.plus(direction.multi(t));
+		};
+
+		result1 = pointAt(tMin);
+		result2 = tMin == tMax ? result1 : pointAt(tMax);
+
+		return true;
+	}
+};
+
+}
+
+#endif /* POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_CONVEXSEARCH_HPP_ */
@@ -23,6 +23,7 @@
 #define POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_POLYGONINTERSECTION_HPP_
 
 #include "CollisionSegmentsFinder.hpp"
+#include "ConvexSearch.hpp"
 #include "IntersectionFromCollisionSegments.hpp"
 #include "../../functional/IMList.hpp"
 #include "../../functional/IMReverseList.hpp"
@@ -158,6 +159,8 @@ private:
 	}
 
 	/** Finds the intersection between a point and a polygon.
+	 *
+	 * Takes logarithmic time in the points of the polygon, see ConvexSearch.
 	 *
 	 * @param point the point
 	 * @param poly the polygon
@@ -167,40 +170,9 @@ private:
 			const std::shared_ptr<const Point> point,
 			const std::shared_ptr<const Polygon> poly) {
 
-		auto polyPlusHeadVector = addAll(*(*poly).points(), std::vector<P>( { {
-				(*poly).myP1 } }));
-		const auto iden = [](const P & p) {return p;};
-		const auto polyPlusHeadList = map<std::vector<P>, std::list<P>,
-				decltype(iden)>(*polyPlusHeadVector, iden);
-
-		const auto polyPlusHead = IMList<const P>::constructFrom(
-				*polyPlusHeadList);
-
-		typedef const std::shared_ptr<const IMList<const P>> GoThroughPolyArg;
-
-		std::function<bool(GoThroughPolyArg)> goThroughPoly;
-		goThroughPoly =
-				[point, goThroughPoly](GoThroughPolyArg polys) -> bool {
-
-					const auto size = (*polys).size();
-
-					if (size >= 2) {
-
-						const auto x1 = *( *polys ).headNull();
-						const auto x2 = *( *(*polys).tailNull() ).headNull();
-						const auto xs = ( *(*polys).tailNull() ).tailNull();
-
-						const auto v1 = x2.minus(x1);
-						const auto v2 = (*point).myPoint.minus(x1);
-
-						return (v1.cross(v2) >= 0.0) && goThroughPoly(IMList<const P>::prepend(x2, xs));
-					}
-					else {
-						return true;
-					}
-				};
+		const auto polyPoints = (*poly).points();
 
-		if (goThroughPoly(polyPlusHead)) {
+		if (ConvexSearch::contains((*polyPoints).data(), (*polyPoints).size(), (*point).myPoint)) {
 			return point;
 		} else {
 			return Empty::getEmpty();
@@ -208,6 +180,8 @@ private:
 	}
 
 	/** Finds the intersection between a line and a polygon.
+	 *
+	 * Takes logarithmic time in the points of the polygon, see ConvexSearch.
 	 *
 	 * @param line the line
 	 * @param poly the polygon
@@ -217,128 +191,19 @@ private:
 			const std::shared_ptr<const Line> line,
 			const std::shared_ptr<const Polygon> poly) {
 
-		typedef const std::shared_ptr<const EmptyPointLine> SHEmptyPointLine;
-
-		typedef const std::shared_ptr<const IMList<const P>> IMListP;
-		typedef const std::shared_ptr<const IMReverseList<SHEmptyPointLine>> IMReverseListEmptyPointLine;
-
-		//Collide all line-segment pairs, and return the results.
-
-		const auto p11 = (*line).myP1;
-		const auto p12 = (*line).myP2;
-
-		auto polygonListPlusHeadTemp = *(*poly).points();
-		polygonListPlusHeadTemp.push_back(polygonListPlusHeadTemp.front()); //NOTE: Add head.
-		const IMListP polygonListPlusHead = IMList<const P>::constructFrom(
-				polygonListPlusHeadTemp);
-
-		const std::function<
-				IMReverseListEmptyPointLine(IMListP,
-						IMReverseListEmptyPointLine)> collideAll =
-				[p11, p12, &collideAll](
-						IMListP polyList,
-						IMReverseListEmptyPointLine res)
-				-> IMReverseListEmptyPointLine {
+		const auto polyPoints = (*poly).points();
 
-					if ((*polyList).size() >= 2) {
-						const auto x1 = *(*polyList).headNull();
-						const auto x2 = *(*(*polyList).tailNull()).headNull();
-						const auto xs = (*(*polyList).tailNull()).tailNull();
+		P p1(0.0, 0.0);
+		P p2(0.0, 0.0);
 
-						const auto p21 = x1;
-						const auto p22 = x2;
+		const auto clipped = ConvexSearch::clipSegment((*polyPoints).data(), (*polyPoints).size(),
+				(*line).myP1, (*line).myP2, p1, p2);
 
-						const auto collisionResult = GeneralFunctions::handleLineLine(p11, p12, p21, p22);
-
-						const auto collisionResultType = (*collisionResult).getType();
-
-						if (collisionResultType == ConvexCCWType::EmptyT) {
-							return collideAll(IMList<const P>::prepend(x2, (*xs).tailNull()), res);
-						}
-						else if (collisionResultType == ConvexCCWType::PointT) {
-							const auto pRes = (*collisionResult).getAPoint();
-							return collideAll(
-									IMList<const P>::prepend(x2, (*xs).tailNull()),
-									IMReverseList<const std::shared_ptr<const EmptyPointLine>>::append(res, pRes)
-							);
-						}
-						else { //Line, since Polygon not possible.
-							const auto lineRes = (*collisionResult).getALine();
-							return IMReverseList<SHEmptyPointLine>::append(IMReverseList<SHEmptyPointLine>::nil(), lineRes);
-						}
-					}
-					else {
-						return res;
-					}
-				};
-
-		const auto part1 = handlePointPolygon(
-				std::shared_ptr<const Point>(new Point(p11)), poly);
-		const auto part2 = handlePointPolygon(
-				std::shared_ptr<const Point>(new Point(p12)), poly);
-
-		const auto insideEnds =
-				IMReverseList<const std::shared_ptr<const EmptyPointLine>>::append(
-						IMReverseList<
-								const std::shared_ptr<const EmptyPointLine>>::create(
-								part1), part2);
-
-		const IMReverseListEmptyPointLine collisions =
-				collideAll(polygonListPlusHead,
-						IMReverseList<
-								const std::shared_ptr<const EmptyPointLine>>::nil());
-
-		const auto finalResultCalc =
-				[collisions, insideEnds]() -> std::shared_ptr<const EmptyPointLine> {
-
-					const auto size = (*collisions).size();
-
-					if (size == 1 && (*(*(*collisions).lastNull())).getType() == ConvexCCWType::LineT) {
-						const auto a = *(*collisions).lastNull();
-						return a;
-					}
-					else {
-
-						//Make a set out of the points, thereby removing duplicates.
-
-						const auto temp1 = IMReverseList<SHEmptyPointLine>::constructTo<std::list<std::shared_ptr<const EmptyPointLine>>>(collisions);
-						const auto temp2 = IMReverseList<SHEmptyPointLine>::constructTo<std::list<std::shared_ptr<const EmptyPointLine>>>(insideEnds);
-						const auto finalFinalRes1 = addAll(*temp1, *temp2);
-
-						const auto filterPoints = [](const std::shared_ptr<const EmptyPointLine> poly) {
-							const auto type = (*poly).getType();
-							return type == ConvexCCWType::PointT;
-						};
-						const auto finalFinalResOnlyPoints = filter(*finalFinalRes1, filterPoints);
-
-						const auto toPoint = [](const std::shared_ptr<const EmptyPointLine> point) {
-							return (*(*point).getAPoint()).myPoint;
-						};
-						const auto finalFinalResPs = map<std::list<std::shared_ptr<const EmptyPointLine>>, std::list<P>, decltype(toPoint)>
-						(*finalFinalResOnlyPoints, toPoint);
-
-						const auto idenP = [](const P p) {return p;};
-						const auto finalFinalResSet = map<std::list<P>, std::set<P, P::Comparer>, decltype(idenP)>(*finalFinalResPs, idenP);
-
-						const auto setSize = (*finalFinalResSet).size();
-						if (setSize == 0) {
-							return Empty::getEmpty();
-						}
-						else if (setSize == 1) {
-							return std::shared_ptr<const Point>(new Point(*(*finalFinalResSet).begin()));
-						}
-						else { //Take the two first.
-							return Line::create(
-									*(*finalFinalResSet).begin(),
-									*(++(*finalFinalResSet).begin())
-							);
-						}
-					}
-				};
-		const auto finalResult = finalResultCalc();
+		const auto result = !clipped ? std::shared_ptr<const EmptyPointLine>(Empty::getEmpty()) :
+				p1.equal(p2) ? std::shared_ptr<const EmptyPointLine>(new Point(p1)) :
+				Line::create(p1, p2);
 
-		return Either<const bool, const ConvexCCWPolygon>::createRight(
-				finalResult);
+		return Either<const bool, const ConvexCCWPolygon>::createRight(result);
 	}
 
 public:
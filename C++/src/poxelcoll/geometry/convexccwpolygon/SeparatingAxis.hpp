@@ -0,0 +1,145 @@
+/* SeparatingAxis.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_SEPARATINGAXIS_HPP_
+#define POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_SEPARATINGAXIS_HPP_
+
+#include <vector>
+
+#include "../../DataTypes.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollgeometryconvexccwpolygon
+ *
+ * Boolean overlap tests for non-empty convex polygons, using the separating axis theorem.
+ *
+ * Two convex polygons do not overlap if and only if there is an axis such that their projections
+ * onto the axis do not overlap. It is enough to try the normals of the edges of the polygons.
+ * A line also has its direction tried, which separates collinear lines, and two points
+ * have the difference between them tried.
+ *
+ * The polygons are given as their points, 1 for a point, 2 for a line and 3 or more for a polygon.
+ * Polygons that only touch overlap. No memory is allocated, which makes it suitable for testing
+ * whether two full masks collide, where only a yes or no is needed, not the intersection itself.
+ */
+class SeparatingAxis {
+
+private:
+
+	static void project(const std::vector<P> & points, const P & axis, double & min, double & max) {
+
+		min = points[0].dot(axis);
+		max = min;
+
+		for (unsigned int i = 1; i < points.size(); i++) {
+			const auto value = points[i].dot(axis);
+			min = value < min ? value : min;
+			max = value > max ? value : max;
+		}
+	}
+
+	/** Tries the normals of the edges of the first polygon, as well as the direction if it is a line.
+	 */
+	static const bool findAmongEdges(const std::vector<P> & points1, const std::vector<P> & points2, P & axis) {
+
+		const auto size = points1.size();
+
+		if (size < 2) {
+			return false;
+		}
+
+		const auto edgeCount = size == 2 ? 1 : size;
+
+		for (unsigned int i = 0; i < edgeCount; i++) {
+
+			const auto edge = points1[(i + 1) % size].minus(points1[i]);
+			const P normal(edge.gY(), -edge.gX());
+
+			if (separates(points1, points2, normal)) {
+				axis = normal;
+				return true;
+			}
+			if (size == 2 && separates(points1, points2, edge)) {
+				axis = edge;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+public:
+
+	/** Whether the projections of the polygons onto the given axis do not overlap.
+	 *
+	 * @param points1 the non-empty points of the first polygon
+	 * @param points2 the non-empty points of the second polygon
+	 * @param axis the axis, which need not be normalized
+	 * @return whether the axis separates the polygons
+	 */
+	static const bool separates(const std::vector<P> & points1, const std::vector<P> & points2, const P & axis) {
+
+		double min1, max1, min2, max2;
+		project(points1, axis, min1, max1);
+		project(points2, axis, min2, max2);
+
+		return max1 < min2 || max2 < min1;
+	}
+
+	/** Finds an axis that separates the polygons, if any.
+	 *
+	 * @param points1 the non-empty points of the first polygon
+	 * @param points2 the non-empty points of the second polygon
+	 * @param axis set to the separating axis if one is found, else left as it is
+	 * @return whether a separating axis was found, ie. whether the polygons do not overlap
+	 */
+	static const bool findSeparatingAxis(const std::vector<P> & points1, const std::vector<P> & points2, P & axis) {
+
+		if (points1.size() == 1 && points2.size() == 1) {
+			if (points1[0].equal(points2[0])) {
+				return false;
+			}
+			else {
+				axis = points2[0].minus(points1[0]);
+				return true;
+			}
+		}
+		else {
+			return findAmongEdges(points1, points2, axis) || findAmongEdges(points2, points1, axis);
+		}
+	}
+
+	/** Whether the polygons overlap.
+	 *
+	 * @param points1 the non-empty points of the first polygon
+	 * @param points2 the non-empty points of the second polygon
+	 * @return whether the polygons overlap, including if they only touch
+	 */
+	static const bool overlaps(const std::vector<P> & points1, const std::vector<P> & points2) {
+		P axis(0.0, 0.0);
+		return !findSeparatingAxis(points1, points2, axis);
+	}
+};
+
+}
+
+#endif /* POXELCOLL_GEOMETRY_CONVEXCCWPOLYGON_SEPARATINGAXIS_HPP_ */
@@ -30,5 +30,12 @@
   * The different concrete types are meant to improve both the geometric robustness as well
   * as type-safety.
   *
+  * For the hot paths of collision detection, SeparatingAxis tests convex polygons for overlap,
+  * and ConvexClipper finds their intersection, both without allocating any memory.
+  * CompactConvexPolygon holds a small polygon as a plain value, with its points inline,
+  * for keeping many polygons next to each other without reference counts or virtual calls.
+  * ConvexSearch finds extreme points, and whether points and line segments meet a polygon,
+  * in logarithmic time in the points of the polygon.
+  *
   * The package is meant to have geometric stability, but not necessarily numerical stability.
   */
@@ -0,0 +1,86 @@
+/* Affine.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <sstream>
+
+#include "Affine.hpp"
+
+namespace poxelcoll {
+
+Affine::Affine(const double xx, const double xy, const double xc,
+		const double yx, const double yy, const double yc) :
+		myXx(xx), myXy(xy), myXc(xc), myYx(yx), myYy(yy), myYc(yc) {
+}
+
+const Affine Affine::compose(const Affine & that) const {
+
+	return Affine(
+			myXx * that.myXx + myXy * that.myYx, myXx * that.myXy + myXy * that.myYy, myXx * that.myXc + myXy * that.myYc + myXc,
+			myYx * that.myXx + myYy * that.myYx, myYx * that.myXy + myYy * that.myYy, myYx * that.myXc + myYy * that.myYc + myYc);
+}
+
+const Affine Affine::inverseUnsafe() const {
+
+	//The linear part is inverted by swapping the diagonal and negating the rest, divided by the determinant,
+	//and the translation is the negated translation mapped by the inverted linear part.
+	//The expressions are the ones the general 3-by-3 inverse of Matrix reduces to, so the results are the same.
+
+	const auto det = determinant();
+
+	return Affine(
+			myYy / det, -myXy / det, (myXy * myYc - myXc * myYy) / det,
+			-myYx / det, myXx / det, (myXc * myYx - myXx * myYc) / det);
+}
+
+const std::shared_ptr<const std::vector<P>> Affine::transformPoints(const std::vector<P> & points) const {
+
+	const auto result = new std::vector<P>();
+	result->reserve(points.size());
+
+	for (auto i = points.begin(); i != points.end(); i++) {
+		result->push_back(transform(*i));
+	}
+
+	return std::shared_ptr<const std::vector<P>>(result);
+}
+
+const BoundingBox Affine::transformBoundingBox(const BoundingBox & boundingBox) const {
+
+	const auto p1 = transform(boundingBox.pMin);
+	const auto p2 = transform(boundingBox.pMax);
+	const auto p3 = transform(P(boundingBox.pMin.gX(), boundingBox.pMax.gY()));
+	const auto p4 = transform(P(boundingBox.pMax.gX(), boundingBox.pMin.gY()));
+
+	return BoundingBox(
+			P(std::min(std::min(p1.gX(), p2.gX()), std::min(p3.gX(), p4.gX())),
+					std::min(std::min(p1.gY(), p2.gY()), std::min(p3.gY(), p4.gY()))),
+			P(std::max(std::max(p1.gX(), p2.gX()), std::max(p3.gX(), p4.gX())),
+					std::max(std::max(p1.gY(), p2.gY()), std::max(p3.gY(), p4.gY()))));
+}
+
+const std::string Affine::toString() const {
+	std::ostringstream s;
+	s << myXx << ", " << myXy << ", " << myXc << ", " << myYx << ", " << myYy << ", " << myYc;
+	return s.str();
+}
+
+}
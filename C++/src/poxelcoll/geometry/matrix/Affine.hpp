@@ -0,0 +1,154 @@
+/* Affine.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_GEOMETRY_MATRIX_AFFINE_HPP_
+#define POXELCOLL_GEOMETRY_MATRIX_AFFINE_HPP_
+
+#include <math.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../DataTypes.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollgeometrymatrix
+ *
+ * The kind of an affine transformation, from the most to the least constrained.
+ * An inverse always has the same kind as the transformation.
+ */
+enum class TransformKind {
+	IntegerTranslationK, //Only translated, by whole pixels.
+	TranslationK, //Only translated.
+	AxisAlignedK, //Scaled along the axes and translated, possibly mirrored.
+	QuarterTurnK, //Rotated a multiple of 90 degrees that swaps the axes, and scaled and translated.
+	GeneralK //Anything else.
+};
+
+/** \ingroup poxelcollgeometrymatrix
+ *
+ * An affine transformation, ie. a 3-by-3 matrix whose last row is always (0, 0, 1).
+ *
+ * Only the first 2 rows are kept:
+ *
+ * [ xx  xy  xc ]
+ * [ yx  yy  yc ]
+ *
+ * such that the point (x, y) is transformed to (xx * x + xy * y + xc, yx * x + yy * y + yc).
+ *
+ * Unlike Matrix, it is a small value type: composing, inverting and transforming points and bounding boxes
+ * never allocates. The general inverse is found from the determinant and the adjugate of the linear part.
+ * The inverse of the transformation of a collision object is instead found in closed form from its angle and scaling,
+ * see Transformation::getInverseAffineTransformationUnsafe.
+ */
+class Affine {
+private:
+	double myXx, myXy, myXc; //Do not change.
+	double myYx, myYy, myYc; //Do not change.
+
+public:
+
+	Affine(const double xx, const double xy, const double xc,
+			const double yx, const double yy, const double yc);
+
+	const double xx() const { return myXx; }
+	const double xy() const { return myXy; }
+	const double xc() const { return myXc; }
+	const double yx() const { return myYx; }
+	const double yy() const { return myYy; }
+	const double yc() const { return myYc; }
+
+	/** @return the affine transformation that does nothing */
+	static const Affine identity() {
+		return Affine(1.0, 0.0, 0.0, 0.0, 1.0, 0.0);
+	}
+
+	/** The composition of this transformation after the given one, like this * that.
+	 *
+	 * @param that the transformation to apply first
+	 * @return the composed transformation
+	 */
+	const Affine compose(const Affine & that) const;
+
+	/** @return the determinant of the linear part */
+	const double determinant() const {
+		return myXx * myYy - myXy * myYx;
+	}
+
+	/** Whether the transformation has an inverse, ie. whether the determinant is not zero. */
+	const bool hasInverse() const {
+		return determinant() != 0.0;
+	}
+
+	/** The inverse of this transformation, from the determinant and the adjugate of the linear part. Undefined if it has no inverse.
+	 *
+	 * @return the inverse transformation
+	 */
+	const Affine inverseUnsafe() const;
+
+	/** @return the kind of the transformation, found from its exact entries */
+	const TransformKind kind() const {
+		if (myXy == 0.0 && myYx == 0.0) {
+			if (myXx == 1.0 && myYy == 1.0) {
+				return myXc == floor(myXc) && myYc == floor(myYc) ?
+						TransformKind::IntegerTranslationK : TransformKind::TranslationK;
+			}
+			else {
+				return TransformKind::AxisAlignedK;
+			}
+		}
+		else if (myXx == 0.0 && myYy == 0.0) {
+			return TransformKind::QuarterTurnK;
+		}
+		else {
+			return TransformKind::GeneralK;
+		}
+	}
+
+	/** @param p the point
+	 * @return the transformed point
+	 */
+	const P transform(const P & p) const {
+		return P(myXx * p.gX() + myXy * p.gY() + myXc,
+				myYx * p.gX() + myYy * p.gY() + myYc);
+	}
+
+	/** Transform a sequence of points.
+	 *
+	 * @param points the sequence of points to be transformed
+	 * @return the transformed points
+	 */
+	const std::shared_ptr<const std::vector<P>> transformPoints(const std::vector<P> & points) const;
+
+	/** The axis-aligned bounding box of the transformed given axis-aligned bounding box.
+	 *
+	 * @param boundingBox the axis-aligned bounding box
+	 * @return the axis-aligned bounding box of the transformed box
+	 */
+	const BoundingBox transformBoundingBox(const BoundingBox & boundingBox) const;
+
+	const std::string toString() const;
+};
+
+}
+
+#endif /* POXELCOLL_GEOMETRY_MATRIX_AFFINE_HPP_ */
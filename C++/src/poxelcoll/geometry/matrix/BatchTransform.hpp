@@ -0,0 +1,181 @@
+/* BatchTransform.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_GEOMETRY_MATRIX_BATCHTRANSFORM_HPP_
+#define POXELCOLL_GEOMETRY_MATRIX_BATCHTRANSFORM_HPP_
+
+#if defined(__SSE2__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#include "Affine.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollgeometrymatrix
+ *
+ * Transforms many points by the same affine transformation, with the points given as a structure of arrays,
+ * ie. the x-coordinates in one array and the y-coordinates in another.
+ *
+ * That way, the same entry of the transformation applies to every lane of a vector register,
+ * so several points are transformed per instruction: with AVX, 8 points in single precision or 4 in double precision,
+ * and with SSE, 4 in single precision or 2 in double precision. AVX is only used if the library is compiled for it,
+ * for instance with -mavx, while SSE2 is always there on x86-64. Other targets transform one point at a time.
+ *
+ * The double precision variant gives exactly the same points as Affine::transform, since the products and sums
+ * are done in the same order. The single precision variant rounds the entries of the transformation to floats,
+ * so it suits uses that tolerate an error of a fraction of a pixel, and halves the memory traffic.
+ *
+ * The arrays need not be aligned, and the output may be the same arrays as the input.
+ */
+class BatchTransform {
+
+private:
+
+	template <typename Scalar>
+	static void transformOneByOne(const Affine & transformation, const Scalar * const xs, const Scalar * const ys,
+			const unsigned int begin, const unsigned int count, Scalar * const outXs, Scalar * const outYs) {
+
+		const auto xx = (Scalar) transformation.xx();
+		const auto xy = (Scalar) transformation.xy();
+		const auto xc = (Scalar) transformation.xc();
+		const auto yx = (Scalar) transformation.yx();
+		const auto yy = (Scalar) transformation.yy();
+		const auto yc = (Scalar) transformation.yc();
+
+		for (unsigned int i = begin; i < count; i++) {
+			const auto x = xs[i];
+			const auto y = ys[i];
+			outXs[i] = xx * x + xy * y + xc;
+			outYs[i] = yx * x + yy * y + yc;
+		}
+	}
+
+public:
+
+	/** Transforms points in single precision.
+	 *
+	 * @param transformation the transformation
+	 * @param xs the x-coordinates of the points
+	 * @param ys the y-coordinates of the points
+	 * @param count the number of points
+	 * @param outXs set to the x-coordinates of the transformed points
+	 * @param outYs set to the y-coordinates of the transformed points
+	 */
+	static void transform(const Affine & transformation, const float * const xs, const float * const ys,
+			const unsigned int count, float * const outXs, float * const outYs) {
+
+		unsigned int i = 0;
+
+#if defined(__AVX__)
+		{
+			const auto xx = _mm256_set1_ps((float) transformation.xx());
+			const auto xy = _mm256_set1_ps((float) transformation.xy());
+			const auto xc = _mm256_set1_ps((float) transformation.xc());
+			const auto yx = _mm256_set1_ps((float) transformation.yx());
+			const auto yy = _mm256_set1_ps((float) transformation.yy());
+			const auto yc = _mm256_set1_ps((float) transformation.yc());
+
+			for (; i + 8 <= count; i += 8) {
+				const auto x = _mm256_loadu_ps(xs + i);
+				const auto y = _mm256_loadu_ps(ys + i);
+				_mm256_storeu_ps(outXs + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xx, x), _mm256_mul_ps(xy, y)), xc));
+				_mm256_storeu_ps(outYs + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(yx, x), _mm256_mul_ps(yy, y)), yc));
+			}
+		}
+#endif
+#if defined(__SSE2__)
+		{
+			const auto xx = _mm_set1_ps((float) transformation.xx());
+			const auto xy = _mm_set1_ps((float) transformation.xy());
+			const auto xc = _mm_set1_ps((float) transformation.xc());
+			const auto yx = _mm_set1_ps((float) transformation.yx());
+			const auto yy = _mm_set1_ps((float) transformation.yy());
+			const auto yc = _mm_set1_ps((float) transformation.yc());
+
+			for (; i + 4 <= count; i += 4) {
+				const auto x = _mm_loadu_ps(xs + i);
+				const auto y = _mm_loadu_ps(ys + i);
+				_mm_storeu_ps(outXs + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, x), _mm_mul_ps(xy, y)), xc));
+				_mm_storeu_ps(outYs + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(yx, x), _mm_mul_ps(yy, y)), yc));
+			}
+		}
+#endif
+
+		transformOneByOne(transformation, xs, ys, i, count, outXs, outYs);
+	}
+
+	/** Transforms points in double precision, giving the same points as Affine::transform.
+	 *
+	 * @param transformation the transformation
+	 * @param xs the x-coordinates of the points
+	 * @param ys the y-coordinates of the points
+	 * @param count the number of points
+	 * @param outXs set to the x-coordinates of the transformed points
+	 * @param outYs set to the y-coordinates of the transformed points
+	 */
+	static void transform(const Affine & transformation, const double * const xs, const double * const ys,
+			const unsigned int count, double * const outXs, double * const outYs) {
+
+		unsigned int i = 0;
+
+#if defined(__AVX__)
+		{
+			const auto xx = _mm256_set1_pd(transformation.xx());
+			const auto xy = _mm256_set1_pd(transformation.xy());
+			const auto xc = _mm256_set1_pd(transformation.xc());
+			const auto yx = _mm256_set1_pd(transformation.yx());
+			const auto yy = _mm256_set1_pd(transformation.yy());
+			const auto yc = _mm256_set1_pd(transformation.yc());
+
+			for (; i + 4 <= count; i += 4) {
+				const auto x = _mm256_loadu_pd(xs + i);
+				const auto y = _mm256_loadu_pd(ys + i);
+				_mm256_storeu_pd(outXs + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(xx, x), _mm256_mul_pd(xy, y)), xc));
+				_mm256_storeu_pd(outYs + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(yx, x), _mm256_mul_pd(yy, y)), yc));
+			}
+		}
+#endif
+#if defined(__SSE2__)
+		{
+			const auto xx = _mm_set1_pd(transformation.xx());
+			const auto xy = _mm_set1_pd(transformation.xy());
+			const auto xc = _mm_set1_pd(transformation.xc());
+			const auto yx = _mm_set1_pd(transformation.yx());
+			const auto yy = _mm_set1_pd(transformation.yy());
+			const auto yc = _mm_set1_pd(transformation.yc());
+
+			for (; i + 2 <= count; i += 2) {
+				const auto x = _mm_loadu_pd(xs + i);
+				const auto y = _mm_loadu_pd(ys + i);
+				_mm_storeu_pd(outXs + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(xx, x), _mm_mul_pd(xy, y)), xc));
+				_mm_storeu_pd(outYs + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(yx, x), _mm_mul_pd(yy, y)), yc));
+			}
+		}
+#endif
+
+		transformOneByOne(transformation, xs, ys, i, count, outXs, outYs);
+	}
+};
+
+}
+
+#endif /* POXELCOLL_GEOMETRY_MATRIX_BATCHTRANSFORM_HPP_ */
@@ -59,6 +59,10 @@ const std::shared_ptr<const Matrix> Matrix::matrixMult(const Matrix& that) const
 	return std::shared_ptr<const Matrix>(new Matrix(result3));
 }
 
+const double Matrix::at(const unsigned int row, const unsigned int column) const {
+	return data[row * 3 + column];
+}
+
 const P3 Matrix::vectorMult(const P3 p) const {
 
 	const auto d = data;
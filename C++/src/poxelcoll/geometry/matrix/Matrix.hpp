@@ -71,6 +71,14 @@ public:
 	 */
 	const std::shared_ptr<const Matrix> matrixMult(const Matrix& that) const;
 
+	/** The entry at the given row and column.
+	 *
+	 * @param row value in the range [0; 3[
+	 * @param column value in the range [0; 3[
+	 * @return the entry
+	 */
+	const double at(const unsigned int row, const unsigned int column) const;
+
 	/** Multiply this matrix with a vector, like M * v.
 	 *
 	 * @param p the vector
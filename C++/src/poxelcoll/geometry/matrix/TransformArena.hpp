@@ -0,0 +1,162 @@
+/* TransformArena.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_GEOMETRY_MATRIX_TRANSFORMARENA_HPP_
+#define POXELCOLL_GEOMETRY_MATRIX_TRANSFORMARENA_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include "Affine.hpp"
+#include "BatchTransform.hpp"
+#include "../../DataTypes.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcollgeometrymatrix
+ *
+ * Keeps the point sets of many objects, such as their hulls or the corners of their bounding boxes,
+ * each with its own transformation, in one contiguous structure of arrays, and transforms all of them in one pass.
+ *
+ * It is meant to live for a frame: the point sets of the frame are added, transformAll is called once,
+ * and the transformed points are read back. Clearing it keeps the memory, so a reused arena stops allocating
+ * once it has held the largest frame. See BatchTransform for the precision of the two variants.
+ */
+template <typename Scalar>
+class TransformArena {
+
+private:
+
+	/** A point set, which is the points from begin up to begin + size. */
+	struct Set {
+		unsigned int begin;
+		unsigned int size;
+		Affine transformation;
+	};
+
+	std::vector<Scalar> myXs;
+	std::vector<Scalar> myYs;
+	std::vector<Set> sets;
+
+public:
+
+	/** Forgets all point sets, keeping the memory. */
+	void clear() {
+		myXs.clear();
+		myYs.clear();
+		sets.clear();
+	}
+
+	/** Makes room for a number of point sets with a number of points in total, to avoid growing while adding. */
+	void reserve(const unsigned int setCount, const unsigned int pointCount) {
+		myXs.reserve(pointCount);
+		myYs.reserve(pointCount);
+		sets.reserve(setCount);
+	}
+
+	/** Adds a point set, which is not transformed until transformAll is called.
+	 *
+	 * @param points the points
+	 * @param size the number of points
+	 * @param transformation the transformation of the points
+	 * @return the index of the point set, which counts from 0 in the order the sets are added
+	 */
+	const unsigned int add(const P * const points, const unsigned int size, const Affine & transformation) {
+
+		const Set set = { (unsigned int) myXs.size(), size, transformation };
+		sets.push_back(set);
+
+		for (unsigned int i = 0; i < size; i++) {
+			myXs.push_back((Scalar) points[i].gX());
+			myYs.push_back((Scalar) points[i].gY());
+		}
+
+		return sets.size() - 1;
+	}
+
+	/** Adds the 4 corners of a bounding box as a point set, see add. */
+	const unsigned int addCorners(const BoundingBox & boundingBox, const Affine & transformation) {
+		const P corners[] = { boundingBox.pMin, P(boundingBox.pMax.gX(), boundingBox.pMin.gY()),
+				boundingBox.pMax, P(boundingBox.pMin.gX(), boundingBox.pMax.gY()) };
+		return add(corners, 4, transformation);
+	}
+
+	/** Transforms every point set by its transformation, in place. Call it once, after all the point sets are added. */
+	void transformAll() {
+		for (auto set = sets.begin(); set != sets.end(); set++) {
+			const auto begin = (*set).begin;
+			BatchTransform::transform((*set).transformation, myXs.data() + begin, myYs.data() + begin, (*set).size,
+					myXs.data() + begin, myYs.data() + begin);
+		}
+	}
+
+	/** The number of point sets. */
+	const unsigned int setCount() const {
+		return sets.size();
+	}
+
+	/** The number of points in a point set. */
+	const unsigned int size(const unsigned int setIndex) const {
+		return sets[setIndex].size;
+	}
+
+	/** The x-coordinates of the points of a point set, of which there are size(setIndex). */
+	const Scalar * xs(const unsigned int setIndex) const {
+		return myXs.data() + sets[setIndex].begin;
+	}
+
+	/** The y-coordinates of the points of a point set, of which there are size(setIndex). */
+	const Scalar * ys(const unsigned int setIndex) const {
+		return myYs.data() + sets[setIndex].begin;
+	}
+
+	/** A point of a point set. */
+	const P point(const unsigned int setIndex, const unsigned int i) const {
+		const auto index = sets[setIndex].begin + i;
+		return P(myXs[index], myYs[index]);
+	}
+
+	/** The axis-aligned bounding box of a non-empty point set. */
+	const BoundingBox boundingBox(const unsigned int setIndex) const {
+
+		const auto xs = this->xs(setIndex);
+		const auto ys = this->ys(setIndex);
+		const auto size = this->size(setIndex);
+
+		auto xMin = xs[0];
+		auto yMin = ys[0];
+		auto xMax = xMin;
+		auto yMax = yMin;
+
+		for (unsigned int i = 1; i < size; i++) {
+			xMin = std::min(xMin, xs[i]);
+			yMin = std::min(yMin, ys[i]);
+			xMax = std::max(xMax, xs[i]);
+			yMax = std::max(yMax, ys[i]);
+		}
+
+		return BoundingBox(P(xMin, yMin), P(xMax, yMax));
+	}
+};
+
+}
+
+#endif /* POXELCOLL_GEOMETRY_MATRIX_TRANSFORMARENA_HPP_ */
@@ -22,7 +22,9 @@
 #ifndef POXELCOLL_GEOMETRY_MATRIX_TRANSFORMATION_HPP_
 #define POXELCOLL_GEOMETRY_MATRIX_TRANSFORMATION_HPP_
 
+#include "Affine.hpp"
 #include "Matrix.hpp"
+#include "../convexccwpolygon/ConvexSearch.hpp"
 
 using namespace poxelcoll::functional;
 
@@ -34,8 +36,42 @@ namespace poxelcoll {
  */
 class Transformation {
 
+private:
+
+	/** The cosine and sine of an angle and of the angle plus a quarter turn, which are exact for whole quarter turns.
+	 *
+	 * @param angle the angle in radians
+	 */
+	static void rotationOf(const double angle, double & cosA, double & sinA, double & cosA90, double & sinA90) {
+
+		const auto quarters = angle / (M_PI / 2.0);
+		const auto isQuarterTurns = quarters == floor(quarters) && fabs(quarters) < 1e9;
+
+		//The cosine and sine of 0, 90, 180 and 270 degrees.
+		static const double quarterCos[] = { 1.0, 0.0, -1.0, 0.0 };
+		static const double quarterSin[] = { 0.0, 1.0, 0.0, -1.0 };
+		const auto quarter = isQuarterTurns ? (((long long) quarters) % 4 + 4) % 4 : 0;
+
+		const auto ang90 = angle + M_PI / 2.0;
+		cosA = isQuarterTurns ? quarterCos[quarter] : cos(angle);
+		sinA = isQuarterTurns ? quarterSin[quarter] : sin(angle);
+		cosA90 = isQuarterTurns ? -sinA : cos(ang90);
+		sinA90 = isQuarterTurns ? cosA : sin(ang90);
+	}
+
 public:
 
+	/** Whether the transformation of a collision object is a pure translation,
+	 * ie. it is neither rotated nor scaled.
+	 *
+	 * @param collInfo the collision info of a collision object
+	 * @return whether the angle is 0 and both scales are 1
+	 */
+	static const bool isTranslationOnly(const std::shared_ptr<const CollisionInfo> collInfo) {
+		return (*collInfo).gAngle() == 0.0 && (*collInfo).gScaleX() == 1.0
+				&& (*collInfo).gScaleY() == 1.0;
+	}
+
 	/** Given the info of a collision object, derive a transformation matrix
 	 * from it.
 	 *
@@ -75,8 +111,7 @@ public:
 
 //NOTE: If any bugs are found in the below code, please fix them in the above out-commented code too.
 
-		if ((*collInfo).gAngle() != 0.0 || (*collInfo).gScaleX() != 1.0
-				|| (*collInfo).gScaleY() != 1) {
+		if (!isTranslationOnly(collInfo)) {
 
 			const auto pos = (*collInfo).gPosition();
 			const double posX = pos.gX();
@@ -130,6 +165,136 @@ public:
 		 */
 	}
 
+	/** Given the info of a collision object, derive the affine transformation from it.
+	 *
+	 * The entries are the same as those of the first 2 rows of getTransformationMatrix,
+	 * but nothing is allocated. The exception is angles that are whole multiples of 90 degrees,
+	 * where the cosine and sine are exactly 0, 1 or -1, such that the kind of the transformation
+	 * is found to be axis-aligned or a quarter turn.
+	 *
+	 * The transformation is found once when the collision info is created, see CollisionInfo::gTransformation.
+	 *
+	 * @param collInfo the collision info of a collision object
+	 * @return an affine transformation that handles origin, translation, scaling and rotation
+	 */
+	static const Affine getAffineTransformation(
+			const std::shared_ptr<const CollisionInfo> collInfo) {
+
+		return (*collInfo).gTransformation();
+	}
+
+	/** Given the origin of a mask and the position, angle and scaling of a collision object,
+	 * derive the affine transformation from them, the same way as for a collision info.
+	 *
+	 * @param origin the origin point of the mask
+	 * @param position the position
+	 * @param angle the angle in radians
+	 * @param scaleX the scaling along the x-axis
+	 * @param scaleY the scaling along the y-axis
+	 * @return an affine transformation that handles origin, translation, scaling and rotation
+	 */
+	static const Affine getAffineTransformation(const P origin, const P position,
+			const double angle, const double scaleX, const double scaleY) {
+
+		const double originX = origin.gX();
+		const double originY = origin.gY();
+		const double posX = position.gX();
+		const double posY = position.gY();
+
+		if (!(angle == 0.0 && scaleX == 1.0 && scaleY == 1.0)) {
+
+			double cosA, sinA, cosA90, sinA90;
+			rotationOf(angle, cosA, sinA, cosA90, sinA90);
+
+			return Affine(
+					cosA * scaleX, scaleY * sinA, -cosA * originX * scaleX - originY * scaleY * sinA + posX,
+					cosA90 * scaleX, scaleY * sinA90, -cosA90 * originX * scaleX - originY * scaleY * sinA90 + posY);
+		} else {
+			return Affine(1.0, 0.0, -originX + posX, 0.0, 1.0, -originY + posY);
+		}
+	}
+
+	/** Given the origin of a mask and the position, angle and scaling of a collision object,
+	 * derive the inverse of the affine transformation from them in closed form. Undefined if a scaling is 0.
+	 *
+	 * The transformation is the rotation times the scaling, so the inverse is the reciprocal scaling
+	 * times the transposed rotation, with the same cosines and sines as getAffineTransformation
+	 * (exact for quarter turns), followed by moving the position back to the origin.
+	 *
+	 * @param origin the origin point of the mask
+	 * @param position the position
+	 * @param angle the angle in radians
+	 * @param scaleX the non-zero scaling along the x-axis
+	 * @param scaleY the non-zero scaling along the y-axis
+	 * @return the inverse of the affine transformation of getAffineTransformation
+	 */
+	static const Affine getInverseAffineTransformationUnsafe(const P origin, const P position,
+			const double angle, const double scaleX, const double scaleY) {
+
+		const double originX = origin.gX();
+		const double originY = origin.gY();
+		const double posX = position.gX();
+		const double posY = position.gY();
+
+		if (!(angle == 0.0 && scaleX == 1.0 && scaleY == 1.0)) {
+
+			double cosA, sinA, cosA90, sinA90;
+			rotationOf(angle, cosA, sinA, cosA90, sinA90);
+
+			//The rows of the rotation are (cosA, sinA) and (cosA90, sinA90), so its transpose has them as columns.
+
+			const auto xx = sinA90 / scaleX;
+			const auto xy = -sinA / scaleX;
+			const auto yx = -cosA90 / scaleY;
+			const auto yy = cosA / scaleY;
+
+			return Affine(
+					xx, xy, originX - xx * posX - xy * posY,
+					yx, yy, originY - yx * posX - yy * posY);
+		} else {
+			return Affine(1.0, 0.0, originX - posX, 0.0, 1.0, originY - posY);
+		}
+	}
+
+	/** Given the points of a convex counter-clockwise hull and a transformation of it,
+	 * find the axis-aligned bounding box of the transformed hull.
+	 *
+	 * The point of the transformed hull that lies farthest along an axis is the transformation of the point of the hull
+	 * that lies farthest along the corresponding row of the transformation, so the hull is not transformed;
+	 * instead the 4 extreme points are found in logarithmic time of the points on the hull, see ConvexSearch.
+	 *
+	 * The box is never larger than the transformed bounding box of the mask,
+	 * and for a rotated object it is often much smaller.
+	 *
+	 * @param hullPoints the non-empty points of the hull
+	 * @param transformation the transformation
+	 * @return the axis-aligned bounding box of the transformed hull
+	 */
+	static const BoundingBox getTightBoundingBox(const std::vector<P> & hullPoints, const Affine & transformation) {
+
+		const auto points = hullPoints.data();
+		const auto size = hullPoints.size();
+
+		if (size < 3) { //A point or a line, which the search does not handle.
+
+			const auto p1 = transformation.transform(points[0]);
+			const auto p2 = transformation.transform(points[size - 1]);
+
+			return BoundingBox(P(std::min(p1.gX(), p2.gX()), std::min(p1.gY(), p2.gY())),
+					P(std::max(p1.gX(), p2.gX()), std::max(p1.gY(), p2.gY())));
+		}
+
+		const P rowX(transformation.xx(), transformation.xy());
+		const P rowY(transformation.yx(), transformation.yy());
+
+		const auto xMin = transformation.transform(points[ConvexSearch::extremeIndex(points, size, rowX.multi(-1.0))]).gX();
+		const auto xMax = transformation.transform(points[ConvexSearch::extremeIndex(points, size, rowX)]).gX();
+		const auto yMin = transformation.transform(points[ConvexSearch::extremeIndex(points, size, rowY.multi(-1.0))]).gY();
+		const auto yMax = transformation.transform(points[ConvexSearch::extremeIndex(points, size, rowY)]).gY();
+
+		return BoundingBox(P(xMin, yMin), P(xMax, yMax));
+	}
+
 	/** Given a transformation matrix and an axis-aligned bounding box,
 	 * find the axis-aligned bounding box of the transformed axis-aligned bounding box.
 	 *
@@ -21,6 +21,10 @@
   * \ingroup poxelcollgeometry
   * 
   * The matrix package provides 3-by-3 matrices, methods for generating them, and uses for them.
+  * Affine transformations, which is what collision objects use, also have their own compact type, Affine,
+  * which never allocates and has a closed-form inverse.
+  * Many points can be transformed at once with BatchTransform, several per instruction,
+  * and the points of many objects can be gathered and transformed in one pass with TransformArena.
   *
   * The basic transformation matrix that is generated is consistent with the rest of the library.
   * Be careful about obeying invariants in other parts of the library if changing this matrix
@@ -25,9 +25,16 @@ namespace poxelcoll {
 
 Mask::Mask(const P origin, const BoundingBox boundingBox,
 		const std::shared_ptr<const NonemptyConvexCCWPolygon> convexHull,
-		const std::shared_ptr<const BinaryImage> binaryImageNull) :
+		const std::shared_ptr<const BinaryImage> binaryImageNull,
+		const std::shared_ptr<const OccupancyPyramid> occupancyPyramidNull,
+		const std::shared_ptr<const MaskExtents> extentsNull,
+		const std::shared_ptr<const RotatedMaskCache> rotatedMasksNull,
+		const std::shared_ptr<const std::vector<std::shared_ptr<const ConvexCCWPolygon>>> subHullsNull) :
 		myOrigin(origin), myBoundingBox(boundingBox), myConvexHull(
-				convexHull), myBinaryImageNull(binaryImageNull) {
+				convexHull), myBinaryImageNull(binaryImageNull),
+				myOccupancyPyramidNull(occupancyPyramidNull),
+				myExtentsNull(extentsNull), myRotatedMasksNull(rotatedMasksNull),
+				mySubHullsNull(subHullsNull) {
 }
 
 const P Mask::origin() const {
@@ -46,6 +53,22 @@ const std::shared_ptr<const BinaryImage> Mask::binaryImageNull() const {
 	return myBinaryImageNull;
 }
 
+const std::shared_ptr<const OccupancyPyramid> Mask::occupancyPyramidNull() const {
+	return myOccupancyPyramidNull;
+}
+
+const std::shared_ptr<const MaskExtents> Mask::extentsNull() const {
+	return myExtentsNull;
+}
+
+const std::shared_ptr<const RotatedMaskCache> Mask::rotatedMasksNull() const {
+	return myRotatedMasksNull;
+}
+
+const std::shared_ptr<const std::vector<std::shared_ptr<const ConvexCCWPolygon>>> Mask::subHullsNull() const {
+	return mySubHullsNull;
+}
+
 const bool Mask::isPolygonFull() const {
 	return myBinaryImageNull.get() == 0;
 }
@@ -26,6 +26,10 @@
 
 #include "../DataTypes.hpp"
 #include "../binaryimage/BinaryImage.hpp"
+#include "../binaryimage/OccupancyPyramid.hpp"
+#include "MaskExtents.hpp"
+#include "MaskHull.hpp"
+#include "RotatedMaskCache.hpp"
 #include "../geometry/convexccwpolygon/DataTypes.hpp"
 #include "../geometry/convexccwpolygon/ConvexHull.hpp"
 #include "../binaryimage/SimpleBinaryImage.hpp"
@@ -49,12 +53,21 @@ private:
 	const BoundingBox myBoundingBox;
 	const std::shared_ptr<const NonemptyConvexCCWPolygon> myConvexHull;
 	const std::shared_ptr<const BinaryImage> myBinaryImageNull; //NOTE: Handle potential null.
+	const std::shared_ptr<const OccupancyPyramid> myOccupancyPyramidNull; //NOTE: Handle potential null.
+	const std::shared_ptr<const MaskExtents> myExtentsNull; //NOTE: Handle potential null.
+	const std::shared_ptr<const RotatedMaskCache> myRotatedMasksNull; //NOTE: Handle potential null.
+	const std::shared_ptr<const std::vector<std::shared_ptr<const ConvexCCWPolygon>>> mySubHullsNull; //NOTE: Handle potential null.
 
 public:
 
 	Mask(const P origin, const BoundingBox boundingBox,
 			const std::shared_ptr<const NonemptyConvexCCWPolygon> convexHull,
-			const std::shared_ptr<const BinaryImage> binaryImageNull);
+			const std::shared_ptr<const BinaryImage> binaryImageNull,
+			const std::shared_ptr<const OccupancyPyramid> occupancyPyramidNull = std::shared_ptr<const OccupancyPyramid>(),
+			const std::shared_ptr<const MaskExtents> extentsNull = std::shared_ptr<const MaskExtents>(),
+			const std::shared_ptr<const RotatedMaskCache> rotatedMasksNull = std::shared_ptr<const RotatedMaskCache>(),
+			const std::shared_ptr<const std::vector<std::shared_ptr<const ConvexCCWPolygon>>> subHullsNull =
+					std::shared_ptr<const std::vector<std::shared_ptr<const ConvexCCWPolygon>>>());
 
 	/** The origin point of the mask.
 	 *
@@ -88,6 +101,40 @@ public:
 	 */
 	const std::shared_ptr<const BinaryImage> binaryImageNull() const;
 
+	/** The occupancy pyramid of the binary image if present and built, or none if not.
+	 *
+	 * The pyramid is optional, and lets the pixel tests skip whole empty blocks of the binary image.
+	 *
+	 * @return Some occupancy pyramid or None
+	 */
+	const std::shared_ptr<const OccupancyPyramid> occupancyPyramidNull() const;
+
+	/** The row and column extents of the binary image if present, or none if not.
+	 *
+	 * Masks created from an image source always have the extents.
+	 *
+	 * @return Some extents or None
+	 */
+	const std::shared_ptr<const MaskExtents> extentsNull() const;
+
+	/** The cache of pre-rotated masks if enabled, or none if not.
+	 *
+	 * The cache is optional, and lets collision objects whose angle is on one of a fixed set of angles
+	 * be sampled as only translated.
+	 *
+	 * @return Some cache of pre-rotated masks or None
+	 */
+	const std::shared_ptr<const RotatedMaskCache> rotatedMasksNull() const;
+
+	/** Convex sub-hulls of the binary image if present and the convex hull over-approximates it badly, or none if not.
+	 *
+	 * Together, the sub-hulls cover the binary image, and they cover much less area than the convex hull.
+	 * They are the hulls of horizontal bands of the image, see MaskHull::calculateBandHulls.
+	 *
+	 * @return Some sub-hulls or None
+	 */
+	const std::shared_ptr<const std::vector<std::shared_ptr<const ConvexCCWPolygon>>> subHullsNull() const;
+
 	/** Whether the mask is full or not. Equivalent to whether it does not have a binary image or not.
 	 *
 	 * @return whether the mask is full or not
@@ -101,12 +148,20 @@ public:
 	 *                    must be non-zero, and the row length must be consistent
 	 * @param origin the origin point of the mask
 	 * @param binaryImageFactory the factory for creating the binary image
+	 * @param buildOccupancyPyramid whether to build an occupancy pyramid for the binary image,
+	 *                              which speeds up the pixel tests of concave or sparse images
+	 * @param angleBuckets the number of angle buckets per full turn to keep pre-rotated masks for,
+	 *                     such as 72 for every 5 degrees, or 0 for none. See RotatedMaskCache
+	 * @param rotatedMaskBudget the approximate number of bytes the pre-rotated masks may take up
 	 * @return binary image if input valid, else none
 	 */
 	static const Mask* createMaskNullFromImageSource(
 			const std::deque<std::deque<bool>>& imageSourceRows, const P origin,
 			const BinaryImageFactory& binaryImageFactory =
-					SimpleBinaryImageFactory()) {
+					SimpleBinaryImageFactory(),
+			const bool buildOccupancyPyramid = false,
+			const unsigned int angleBuckets = 0,
+			const size_t rotatedMaskBudget = RotatedMaskCache::defaultMemoryBudget) {
 
 			const
 		auto binaryImageNull = binaryImageFactory.createNull(imageSourceRows); //NOTE: Check for null.
@@ -118,68 +173,76 @@ public:
 			const auto binaryImage = std::shared_ptr<const BinaryImage>(
 					binaryImageNull);
 
-			const auto width = (*binaryImage).width();
-			const auto height = (*binaryImage).height();
-
-			std::vector<P> points;
-			for (unsigned int x = 0; x < width; x++) {
-				for (unsigned int y = 0; y < height; y++) {
-					if ((*binaryImage).hasPoint(x, y)) {
-						points.push_back(P(x, y));
-						points.push_back(P(x + 1, y));
-						points.push_back(P(x, y + 1));
-						points.push_back(P(x + 1, y + 1));
-					}
-				}
-			}
+			return createMaskNullFromBinaryImage(binaryImage, origin, buildOccupancyPyramid, angleBuckets, rotatedMaskBudget);
+		}
+	}
 
-			if (points.empty()) {
-				std::cerr << "The given image source was empty." << std::endl;
-				return 0;
-			} else {
-
-				const auto getX = [](const P p) {return p.gX();};
-				const auto xs = map<std::vector<P>, std::vector<double>,
-						decltype(getX)>(points, getX);
-				const auto xMin = minDefault(*xs, 0.0);
-				const auto xMax = maxDefault(*xs, 0.0);
-
-				const auto getY = [](const P p) {return p.gY();};
-				const auto ys = map<std::vector<P>, std::vector<double>,
-						decltype(getY)>(points, getY);
-				const auto yMin = minDefault(*ys, 0.0);
-				const auto yMax = maxDefault(*ys, 0.0);
-
-				const BoundingBox boundingBox(P(xMin, yMin), P(xMax, yMax));
-
-				const auto someConvexHull = ConvexHull::calculateConvexHull(
-						points);
-
-				const auto type = (*someConvexHull).getType();
-
-				switch (type) {
-				case ConvexCCWType::EmptyT: {
-					std::cerr << "Illegal state, the calculated hull was empty."
-							<< std::endl;
-					throw 1;
-				}
-				case ConvexCCWType::PointT: {
-					const auto point = (*someConvexHull).getAPoint();
-					return new Mask(origin, boundingBox, point, binaryImage);
-				}
-				case ConvexCCWType::LineT: {
-					const auto line = (*someConvexHull).getALine();
-					return new Mask(origin, boundingBox, line, binaryImage);
-				}
-				case ConvexCCWType::PolygonT: {
-					const auto polygon = (*someConvexHull).getAPolygon();
-					return new Mask(origin, boundingBox, polygon, binaryImage);
-				}
-				default: {
-					std::cerr << "Didn't match anything in enum." << std::endl;
-					throw 1;
-				}
-				}
+	/** Creates a mask from the given binary image and origin,
+	 * or none if the binary image has no points on.
+	 *
+	 * @param binaryImage the binary image
+	 * @param origin the origin point of the mask
+	 * @param buildOccupancyPyramid whether to build an occupancy pyramid for the binary image
+	 * @param angleBuckets the number of angle buckets per full turn to keep pre-rotated masks for, or 0 for none
+	 * @param rotatedMaskBudget the approximate number of bytes the pre-rotated masks may take up
+	 * @return binary image if it has points on, else none
+	 */
+	static const Mask* createMaskNullFromBinaryImage(
+			const std::shared_ptr<const BinaryImage> binaryImage, const P origin,
+			const bool buildOccupancyPyramid = false,
+			const unsigned int angleBuckets = 0,
+			const size_t rotatedMaskBudget = RotatedMaskCache::defaultMemoryBudget) {
+
+		const auto extents = std::shared_ptr<const MaskExtents>(new MaskExtents(*binaryImage));
+
+		if ((*extents).isEmpty()) {
+			std::cerr << "The given image source was empty." << std::endl;
+			return 0;
+		} else {
+
+			const BoundingBox boundingBox(
+					P((*extents).firstColumn(), (*extents).firstRow()),
+					P((*extents).lastColumn() + 1, (*extents).lastRow() + 1));
+
+			const auto someConvexHull = MaskHull::calculateConvexHull(*extents);
+
+			const auto occupancyPyramidNull = buildOccupancyPyramid ?
+					std::shared_ptr<const OccupancyPyramid>(new OccupancyPyramid(*binaryImage)) :
+					std::shared_ptr<const OccupancyPyramid>();
+
+			const auto rotatedMasksNull = angleBuckets != 0 ?
+					std::shared_ptr<const RotatedMaskCache>(
+							new RotatedMaskCache(binaryImage, extents, origin, angleBuckets, rotatedMaskBudget)) :
+					std::shared_ptr<const RotatedMaskCache>();
+
+			const auto bandHulls = MaskHull::calculateBandHulls(*extents, *someConvexHull);
+			const auto subHullsNull = (*bandHulls).empty() ?
+					std::shared_ptr<const std::vector<std::shared_ptr<const ConvexCCWPolygon>>>() : bandHulls;
+
+			const auto type = (*someConvexHull).getType();
+
+			switch (type) {
+			case ConvexCCWType::EmptyT: {
+				std::cerr << "Illegal state, the calculated hull was empty."
+						<< std::endl;
+				throw 1;
+			}
+			case ConvexCCWType::PointT: {
+				const auto point = (*someConvexHull).getAPoint();
+				return new Mask(origin, boundingBox, point, binaryImage, occupancyPyramidNull, extents, rotatedMasksNull, subHullsNull);
+			}
+			case ConvexCCWType::LineT: {
+				const auto line = (*someConvexHull).getALine();
+				return new Mask(origin, boundingBox, line, binaryImage, occupancyPyramidNull, extents, rotatedMasksNull, subHullsNull);
+			}
+			case ConvexCCWType::PolygonT: {
+				const auto polygon = (*someConvexHull).getAPolygon();
+				return new Mask(origin, boundingBox, polygon, binaryImage, occupancyPyramidNull, extents, rotatedMasksNull, subHullsNull);
+			}
+			default: {
+				std::cerr << "Didn't match anything in enum." << std::endl;
+				throw 1;
+			}
 			}
 		}
 	}
@@ -248,7 +311,8 @@ public:
 		}
 	}
 
-	static const std::shared_ptr<const Mask> createL(const BinaryImageFactory & binaryImageFactory = SimpleBinaryImageFactory()) {
+	static const std::shared_ptr<const Mask> createL(const BinaryImageFactory & binaryImageFactory = SimpleBinaryImageFactory(),
+			const bool buildOccupancyPyramid = false) {
 
 		const auto width = 30;
 		const auto height = 30;
@@ -265,7 +329,7 @@ public:
 			rows.push_back(row);
 		}
 
-		const auto maskNull = createMaskNullFromImageSource(rows, origin); //NOTE: Handle null.
+		const auto maskNull = createMaskNullFromImageSource(rows, origin, binaryImageFactory, buildOccupancyPyramid); //NOTE: Handle null.
 
 		if (maskNull == 0) { //NOTE: Null, so error.
 			std::cerr << "Illegal state, mask should not be null at this point." << std::endl;
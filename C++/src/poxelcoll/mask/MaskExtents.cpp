@@ -0,0 +1,147 @@
+/* MaskExtents.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MaskExtents.hpp"
+
+#include "../binaryimage/BitsetBinaryImage.hpp"
+
+namespace poxelcoll {
+
+MaskExtents::MaskExtents(const BinaryImage & binaryImage) :
+		myRowMins(binaryImage.height(), 0), myRowMaxs(binaryImage.height(), -1),
+		myColumnMins(binaryImage.width(), 0), myColumnMaxs(binaryImage.width(), -1),
+		myRowOccupancy(binaryImage.height()),
+		myFirstRow(0), myLastRow(-1), myFirstColumn(0), myLastColumn(-1) {
+
+	const auto packedImageNull = dynamic_cast<const BitsetBinaryImage*>(&binaryImage); //NOTE: Handle potential null.
+
+	if (packedImageNull != 0) { //NOTE: Not null, scan the packed words.
+		scanPacked(*packedImageNull);
+	}
+	else { //NOTE: Null, scan point by point.
+		scanPoints(binaryImage);
+	}
+
+	const int height = binaryImage.height();
+
+	for (int y = 0; y < height; y++) {
+		if (myRowOccupancy[y]) {
+			if (isEmpty()) {
+				myFirstRow = y;
+				myFirstColumn = myRowMins[y];
+				myLastColumn = myRowMaxs[y];
+			}
+			myLastRow = y;
+			myFirstColumn = myRowMins[y] < myFirstColumn ? myRowMins[y] : myFirstColumn;
+			myLastColumn = myRowMaxs[y] > myLastColumn ? myRowMaxs[y] : myLastColumn;
+		}
+	}
+}
+
+void MaskExtents::scanPoints(const BinaryImage & binaryImage) {
+
+	const int width = binaryImage.width();
+	const int height = binaryImage.height();
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			if (binaryImage.hasPoint(x, y)) {
+
+				if (!myRowOccupancy[y]) {
+					myRowOccupancy[y] = 1;
+					myRowMins[y] = x;
+				}
+				myRowMaxs[y] = x;
+
+				if (myColumnMaxs[x] < 0) {
+					myColumnMins[x] = y;
+				}
+				myColumnMaxs[x] = y;
+			}
+		}
+	}
+}
+
+void MaskExtents::scanPacked(const BitsetBinaryImage & binaryImage) {
+
+	typedef BitsetBinaryImage::Word Word;
+	const int bitsPerWord = BitsetBinaryImage::bitsPerWord;
+
+	const int height = binaryImage.height();
+	const int wordsPerRow = binaryImage.wordsPerRow();
+
+	//The columns that have had a point on in the rows scanned so far.
+	std::vector<Word> seenFromTop(wordsPerRow, 0);
+	std::vector<Word> seenFromBottom(wordsPerRow, 0);
+
+	//From the top, find the row extents and the first row of each column.
+	//A column's first row is found when its bit is on and has not been seen before.
+
+	for (int y = 0; y < height; y++) {
+
+		const auto row = binaryImage.row(y);
+
+		for (int i = 0; i < wordsPerRow; i++) {
+
+			const auto word = row[i];
+
+			if (word != 0) {
+
+				if (!myRowOccupancy[y]) {
+					myRowOccupancy[y] = 1;
+					myRowMins[y] = i * bitsPerWord + __builtin_ctzll(word);
+				}
+				myRowMaxs[y] = i * bitsPerWord + bitsPerWord - 1 - __builtin_clzll(word);
+
+				auto fresh = word & ~seenFromTop[i];
+				seenFromTop[i] |= word;
+
+				while (fresh != 0) {
+					myColumnMins[i * bitsPerWord + __builtin_ctzll(fresh)] = y;
+					fresh &= fresh - 1;
+				}
+			}
+		}
+	}
+
+	//From the bottom, find the last row of each column in the same way.
+
+	for (int y = height - 1; y >= 0; y--) {
+
+		if (myRowOccupancy[y]) {
+
+			const auto row = binaryImage.row(y);
+
+			for (int i = 0; i < wordsPerRow; i++) {
+
+				auto fresh = row[i] & ~seenFromBottom[i];
+				seenFromBottom[i] |= row[i];
+
+				while (fresh != 0) {
+					myColumnMaxs[i * bitsPerWord + __builtin_ctzll(fresh)] = y;
+					fresh &= fresh - 1;
+				}
+			}
+		}
+	}
+}
+
+}
@@ -0,0 +1,144 @@
+/* MaskExtents.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_MASK_MASKEXTENTS_HPP_
+#define POXELCOLL_MASK_MASKEXTENTS_HPP_
+
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "../binaryimage/BinaryImage.hpp"
+
+namespace poxelcoll {
+
+class BitsetBinaryImage;
+
+/** \ingroup poxelcoll
+ *
+ * The extents of the points that are on in a binary image, per row and per column.
+ *
+ * For each row, the first and last column with a point on is kept, and likewise for each column.
+ * A bitmap tells which rows have any point on. Empty rows and columns have the extent [0; -1].
+ * The extents of the whole image, ie. the tight bounds of the points that are on, are kept as well.
+ *
+ * Bitset binary images are scanned a word at a time, other binary images a point at a time.
+ */
+class MaskExtents {
+
+private:
+
+	std::vector<int> myRowMins;
+	std::vector<int> myRowMaxs;
+	std::vector<int> myColumnMins;
+	std::vector<int> myColumnMaxs;
+	boost::dynamic_bitset<> myRowOccupancy;
+
+	int myFirstRow;
+	int myLastRow;
+	int myFirstColumn;
+	int myLastColumn;
+
+	void scanPoints(const BinaryImage & binaryImage);
+
+	/** Scans the packed rows 64 pixels at a time, in time O(height * wordsPerRow + number of columns). */
+	void scanPacked(const BitsetBinaryImage & binaryImage);
+
+public:
+
+	/** @param binaryImage the binary image, which is only used during construction
+	 */
+	MaskExtents(const BinaryImage & binaryImage);
+
+	/** @return the width of the image */
+	const unsigned int width() const {
+		return myColumnMins.size();
+	}
+
+	/** @return the height of the image */
+	const unsigned int height() const {
+		return myRowMins.size();
+	}
+
+	/** @return whether no point is on in the image */
+	const bool isEmpty() const {
+		return myFirstRow > myLastRow;
+	}
+
+	/** @param y value in the range [0; height[
+	 * @return whether any point in the row is on
+	 */
+	const bool rowIsOccupied(const unsigned int y) const {
+		return myRowOccupancy[y];
+	}
+
+	/** @param y value in the range [0; height[
+	 * @return the first column with a point on in the row, or 0 if the row is empty
+	 */
+	const int rowMin(const unsigned int y) const {
+		return myRowMins[y];
+	}
+
+	/** @param y value in the range [0; height[
+	 * @return the last column with a point on in the row, or -1 if the row is empty
+	 */
+	const int rowMax(const unsigned int y) const {
+		return myRowMaxs[y];
+	}
+
+	/** @param x value in the range [0; width[
+	 * @return the first row with a point on in the column, or 0 if the column is empty
+	 */
+	const int columnMin(const unsigned int x) const {
+		return myColumnMins[x];
+	}
+
+	/** @param x value in the range [0; width[
+	 * @return the last row with a point on in the column, or -1 if the column is empty
+	 */
+	const int columnMax(const unsigned int x) const {
+		return myColumnMaxs[x];
+	}
+
+	/** @return the first row with a point on, or 0 if the image is empty */
+	const int firstRow() const {
+		return myFirstRow;
+	}
+
+	/** @return the last row with a point on, or -1 if the image is empty */
+	const int lastRow() const {
+		return myLastRow;
+	}
+
+	/** @return the first column with a point on, or 0 if the image is empty */
+	const int firstColumn() const {
+		return myFirstColumn;
+	}
+
+	/** @return the last column with a point on, or -1 if the image is empty */
+	const int lastColumn() const {
+		return myLastColumn;
+	}
+};
+
+}
+
+#endif /* POXELCOLL_MASK_MASKEXTENTS_HPP_ */
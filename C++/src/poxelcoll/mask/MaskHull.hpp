@@ -0,0 +1,307 @@
+/* MaskHull.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_MASK_MASKHULL_HPP_
+#define POXELCOLL_MASK_MASKHULL_HPP_
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../DataTypes.hpp"
+#include "../geometry/convexccwpolygon/DataTypes.hpp"
+#include "MaskExtents.hpp"
+
+namespace poxelcoll {
+
+/** \ingroup poxelcoll
+ *
+ * Calculates the convex hull of the pixels of a binary image from its column extents.
+ *
+ * A pixel (x, y) covers the square from (x, y) to (x + 1, y + 1). At the vertical line at a given x,
+ * only the highest and lowest corner of the pixels in the columns to either side can be on the hull,
+ * so at most 2 * (width + 1) points are considered. Those points are already sorted by x,
+ * so the monotone chain algorithm finds the hull in linear time, without any sorting.
+ *
+ * The result is the same as ConvexHull::calculateConvexHull on all the corners of all the pixels that are on.
+ *
+ * For images that their convex hull over-approximates badly, such as L-shapes and rings,
+ * the convex hulls of a few horizontal bands of the image can be found as well.
+ */
+class MaskHull {
+
+private:
+
+	/** Whether the last two points of the chain and the given point do not make a strict left turn.
+	 */
+	static const bool notLeftTurn(const std::vector<P> & chain, const P & p) {
+		const auto p1 = chain[chain.size() - 2];
+		const auto p2 = chain[chain.size() - 1];
+		return p2.minus(p1).cross(p.minus(p1)) <= 0.0;
+	}
+
+	/** The convex hull of points sorted by x, and by y for the same x, by the monotone chain algorithm.
+	 * Collinear points are removed.
+	 *
+	 * @param points the sorted points, which must not all lie on one line
+	 * @return the convex hull
+	 */
+	static const std::shared_ptr<const ConvexCCWPolygon> chainHull(const std::vector<P> & points) {
+
+		std::vector<P> hull;
+		hull.reserve(points.size() + 1);
+
+		for (auto i = points.begin(); i != points.end(); i++) {
+			while (hull.size() >= 2 && notLeftTurn(hull, *i)) {
+				hull.pop_back();
+			}
+			hull.push_back(*i);
+		}
+
+		const auto lowerSize = hull.size() + 1;
+
+		for (auto i = points.rbegin() + 1; i != points.rend(); i++) {
+			while (hull.size() >= lowerSize && notLeftTurn(hull, *i)) {
+				hull.pop_back();
+			}
+			hull.push_back(*i);
+		}
+
+		hull.pop_back(); //The first point is repeated at the end.
+
+		const auto hullLength = hull.size();
+
+		if (hullLength < 3) {
+			std::cerr << "Illegal state, the pixels of a non-empty image have a hull with an area." << std::endl;
+			throw 1;
+		}
+		else {
+			const auto rest = std::shared_ptr<const std::vector<P>>(new std::vector<P>(hull.begin() + 3, hull.end()));
+			return Polygon::createUtterlyUnsafelyNotChecked(hull[0], hull[1], hull[2], rest);
+		}
+	}
+
+	/** Divides the rows [first; last] into bands, by splitting them in two where the bounding boxes
+	 * of the two parts have the least total area, and then splitting each part in the same way,
+	 * as long as a split makes the total area notably smaller.
+	 *
+	 * @param extents the extents of the binary image
+	 * @param first the first row, which must have points on
+	 * @param last the last row, which must have points on
+	 * @param depth the number of times the rows may still be split in two
+	 * @param bands the first and last row of each band, in order
+	 */
+	static void splitIntoBands(const MaskExtents & extents, const int first, const int last, const unsigned int depth,
+			std::vector<std::pair<int, int>> & bands) {
+
+		if (depth == 0 || first == last) {
+			bands.push_back(std::make_pair(first, last));
+			return;
+		}
+
+		//The bounding box areas of the rows [first; y] and of the rows [y; last], for the rows with points on.
+
+		const auto count = last - first + 1;
+		std::vector<double> topAreas(count, 0.0);
+		std::vector<double> bottomAreas(count, 0.0);
+
+		for (int pass = 0; pass < 2; pass++) {
+
+			auto & areas = pass == 0 ? topAreas : bottomAreas;
+			auto xMin = (int) extents.width();
+			auto xMax = -1;
+			auto occupiedRows = 0;
+
+			for (int i = 0; i < count; i++) {
+
+				const auto index = pass == 0 ? i : count - 1 - i;
+				const auto y = first + index;
+
+				if (extents.rowIsOccupied(y)) {
+					xMin = std::min(xMin, extents.rowMin(y));
+					xMax = std::max(xMax, extents.rowMax(y));
+					occupiedRows = i + 1;
+				}
+
+				//The parts start with a row with points on, so the height is up to the last such row.
+				areas[index] = (xMax - xMin + 1.0) * occupiedRows;
+			}
+		}
+
+		auto bestSplit = first;
+		auto bestArea = topAreas[0] + bottomAreas[1];
+
+		for (int i = 1; i < count - 1; i++) {
+			if (topAreas[i] + bottomAreas[i + 1] < bestArea) {
+				bestSplit = first + i;
+				bestArea = topAreas[i] + bottomAreas[i + 1];
+			}
+		}
+
+		if (bestArea > maxBandAreaFraction * topAreas[count - 1]) {
+			bands.push_back(std::make_pair(first, last));
+			return;
+		}
+
+		//Empty rows at the split are left out, so each part starts and ends with rows with points on.
+
+		auto topLast = bestSplit;
+		while (!extents.rowIsOccupied(topLast)) {
+			topLast--;
+		}
+		auto bottomFirst = bestSplit + 1;
+		while (!extents.rowIsOccupied(bottomFirst)) {
+			bottomFirst++;
+		}
+
+		splitIntoBands(extents, first, topLast, depth - 1, bands);
+		splitIntoBands(extents, bottomFirst, last, depth - 1, bands);
+	}
+
+	/** @return the area of a convex polygon */
+	static const double area(const ConvexCCWPolygon & polygon) {
+
+		const auto points = polygon.points();
+
+		auto doubleArea = 0.0;
+		for (unsigned int i = 0; i < (*points).size(); i++) {
+			doubleArea += (*points)[i].cross((*points)[(i + 1) % (*points).size()]);
+		}
+
+		return doubleArea / 2.0;
+	}
+
+public:
+
+	/** Calculates the convex hull of the pixels that are on.
+	 *
+	 * @param extents the extents of the binary image
+	 * @return the convex hull, which is empty if no pixel is on
+	 */
+	static const std::shared_ptr<const ConvexCCWPolygon> calculateConvexHull(const MaskExtents & extents) {
+
+		if (extents.isEmpty()) {
+			return Empty::getEmpty();
+		}
+
+		const int firstColumn = extents.firstColumn();
+		const int lastColumn = extents.lastColumn();
+
+		//The points sorted by x, and by y for the same x.
+
+		std::vector<P> points;
+		points.reserve(2 * (lastColumn - firstColumn + 2));
+
+		for (int x = firstColumn; x <= lastColumn + 1; x++) {
+
+			auto low = 0;
+			auto high = -1;
+
+			for (int column = x - 1; column <= x; column++) {
+				if (column >= firstColumn && column <= lastColumn && extents.columnMax(column) >= 0) {
+					if (high < 0 || extents.columnMin(column) < low) {
+						low = extents.columnMin(column);
+					}
+					if (extents.columnMax(column) + 1 > high) {
+						high = extents.columnMax(column) + 1;
+					}
+				}
+			}
+
+			if (high >= 0) {
+				points.push_back(P(x, low));
+				points.push_back(P(x, high));
+			}
+		}
+
+		return chainHull(points);
+	}
+
+	/** The number of times the rows of an image may be split in two, such that it is divided into at most 4 bands. */
+	static const unsigned int maxBandSplits = 2;
+
+	/** The largest fraction of an area that the parts may cover together for a split to be made,
+	 * and the largest fraction of the area of the convex hull that the bands may cover together for them to be kept. */
+	static constexpr double maxBandAreaFraction = 0.75;
+
+	/** Calculates the convex hulls of a few horizontal bands of the pixels that are on,
+	 * if they over-approximate the pixels notably less than the convex hull of all the pixels does.
+	 *
+	 * The bands are chosen such that their bounding boxes are small, for instance such that an L-shape is split at its corner.
+	 *
+	 * Like the convex hull, the hull of a band is found from the corners of the pixels, such that every band hull
+	 * lies within the convex hull, and testing the band hulls never tests a point that testing the convex hull would not.
+	 *
+	 * @param extents the extents of the binary image
+	 * @param convexHull the convex hull of the pixels that are on
+	 * @return the convex hulls of the bands, or no hulls if the convex hull is tight enough
+	 */
+	static const std::shared_ptr<const std::vector<std::shared_ptr<const ConvexCCWPolygon>>> calculateBandHulls(
+			const MaskExtents & extents, const ConvexCCWPolygon & convexHull) {
+
+		const auto bandHulls = new std::vector<std::shared_ptr<const ConvexCCWPolygon>>();
+		const auto result = std::shared_ptr<const std::vector<std::shared_ptr<const ConvexCCWPolygon>>>(bandHulls);
+
+		if (extents.isEmpty()) {
+			return result;
+		}
+
+		std::vector<std::pair<int, int>> bands;
+		splitIntoBands(extents, extents.firstRow(), extents.lastRow(), maxBandSplits, bands);
+
+		auto bandArea = 0.0;
+
+		for (auto band = bands.begin(); band != bands.end(); band++) {
+
+			std::vector<P> points;
+			points.reserve(4 * ((*band).second - (*band).first + 1));
+
+			for (int y = (*band).first; y <= (*band).second; y++) {
+				if (extents.rowIsOccupied(y)) {
+					points.push_back(P(extents.rowMin(y), y));
+					points.push_back(P(extents.rowMin(y), y + 1.0));
+					points.push_back(P(extents.rowMax(y) + 1.0, y));
+					points.push_back(P(extents.rowMax(y) + 1.0, y + 1.0));
+				}
+			}
+
+			std::sort(points.begin(), points.end(), [](const P & p1, const P & p2) {
+				return p1.gX() < p2.gX() || (p1.gX() == p2.gX() && p1.gY() < p2.gY());
+			});
+
+			const auto bandHull = chainHull(points);
+			bandArea += area(*bandHull);
+			(*bandHulls).push_back(bandHull);
+		}
+
+		if ((*bandHulls).size() < 2 || bandArea > maxBandAreaFraction * area(convexHull)) {
+			(*bandHulls).clear();
+		}
+
+		return result;
+	}
+};
+
+}
+
+#endif /* POXELCOLL_MASK_MASKHULL_HPP_ */
@@ -0,0 +1,208 @@
+/* RotatedMaskCache.cpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "RotatedMaskCache.hpp"
+#include "../CollisionInfo.hpp"
+#include "../binaryimage/BitsetBinaryImage.hpp"
+#include "../geometry/matrix/Transformation.hpp"
+
+namespace poxelcoll {
+
+const double RotatedMaskCache::angleTolerance = 1e-9;
+
+const double RotatedMaskCache::scaleTolerance = 1e-9;
+
+RotatedMaskCache::RotatedMaskCache(const std::shared_ptr<const BinaryImage> aBinaryImage,
+		const std::shared_ptr<const MaskExtents> aExtents, const P aOrigin,
+		const unsigned int angleBuckets, const size_t memoryBudget) :
+		binaryImage(aBinaryImage), extents(aExtents), origin(aOrigin),
+		myAngleBuckets(angleBuckets), myMemoryBudget(memoryBudget), myUsedMemory(0) {
+
+	if (angleBuckets == 0) {
+		std::cerr << "The number of angle buckets must be strictly positive." << std::endl;
+		throw 1;
+	}
+}
+
+const unsigned int RotatedMaskCache::angleBuckets() const {
+	return myAngleBuckets;
+}
+
+const size_t RotatedMaskCache::memoryBudget() const {
+	return myMemoryBudget;
+}
+
+const size_t RotatedMaskCache::usedMemory() const {
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return myUsedMemory;
+}
+
+const std::shared_ptr<const Mask> RotatedMaskCache::rotatedMaskNullOf(const double angle, const double scaleX, const double scaleY) const {
+
+	const auto step = 2.0 * M_PI / myAngleBuckets;
+	const auto steps = round(angle / step);
+
+	if (!(fabs(angle - steps * step) <= angleTolerance) || fabs(steps) > 1e9) {
+		return std::shared_ptr<const Mask>();
+	}
+
+	//Only scalings on a step are baked, so a scaling that changes from frame to frame does not bake a new mask every frame.
+
+	const auto scaleStepsX = round(scaleX * scaleSteps);
+	const auto scaleStepsY = round(scaleY * scaleSteps);
+
+	if (!(fabs(scaleX - scaleStepsX / scaleSteps) <= scaleTolerance) || fabs(scaleStepsX) > 1e6
+			|| !(fabs(scaleY - scaleStepsY / scaleSteps) <= scaleTolerance) || fabs(scaleStepsY) > 1e6) {
+		return std::shared_ptr<const Mask>();
+	}
+
+	const auto buckets = (long long) myAngleBuckets;
+	const Key key = { (int) ((((long long) steps) % buckets + buckets) % buckets), (int) scaleStepsX, (int) scaleStepsY };
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		const auto found = entries.find(key);
+		if (found != entries.end()) {
+			uses.splice(uses.begin(), uses, (*found).second.use);
+			return (*found).second.rotatedMaskNull;
+		}
+	}
+
+	//Baked outside the lock, so other threads are not held up.
+	//If two threads bake the same mask at once, both results are equivalent.
+	//A key without a pre-rotated mask is kept as well, with only the size of the entry, so it is not baked again.
+
+	size_t size = 0;
+	const auto rotatedMaskNull = bake(key, size);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (entries.find(key) == entries.end()) {
+
+			while (myUsedMemory + size > myMemoryBudget && !uses.empty()) {
+				const auto leastRecent = entries.find(uses.back());
+				myUsedMemory -= (*leastRecent).second.size;
+				entries.erase(leastRecent);
+				uses.pop_back();
+			}
+
+			uses.push_front(key);
+			const Entry entry = { rotatedMaskNull, size, uses.begin() };
+			entries[key] = entry;
+			myUsedMemory += size;
+		}
+	}
+
+	return rotatedMaskNull;
+}
+
+const std::shared_ptr<const Mask> RotatedMaskCache::bake(const Key & key, size_t & size) const {
+
+	size = sizeof(Entry);
+
+	const auto angle = key.bucket * (2.0 * M_PI / myAngleBuckets);
+	const auto scaleX = (double) key.scaleX / scaleSteps;
+	const auto scaleY = (double) key.scaleY / scaleSteps;
+	const auto transformation = Transformation::getAffineTransformation(origin, P(0.0, 0.0), angle, scaleX, scaleY);
+
+	if (!transformation.hasInverse()) {
+		return std::shared_ptr<const Mask>();
+	}
+
+	//The same closed-form inverse as the collision info has, such that the baked points are the ones the pixel-perfect test samples.
+
+	const auto inverse = Transformation::getInverseAffineTransformationUnsafe(origin, P(0.0, 0.0), angle, scaleX, scaleY);
+
+	//A point is on if it rounds to a point on in the image, so it lies within half a pixel of the points on.
+
+	const BoundingBox imageBox(
+			P((*extents).firstColumn() - 1.0, (*extents).firstRow() - 1.0),
+			P((*extents).lastColumn() + 1.0, (*extents).lastRow() + 1.0));
+	const auto box = transformation.transformBoundingBox(imageBox);
+
+	const auto xMin = (int) floor(box.pMin.gX());
+	const auto yMin = (int) floor(box.pMin.gY());
+	const auto width = (int) ceil(box.pMax.gX()) - xMin + 1;
+	const auto height = (int) ceil(box.pMax.gY()) - yMin + 1;
+
+	const auto imageWidth = (*extents).width();
+	const auto imageHeight = (*extents).height();
+
+	//Known before sampling, so a mask that could never fit is not sampled at all.
+
+	const auto wordCount = (size_t) ((width + BitsetBinaryImage::bitsPerWord - 1) / BitsetBinaryImage::bitsPerWord) * height;
+	const auto bakedSize = wordCount * sizeof(BitsetBinaryImage::Word) + 4 * (width + height) * sizeof(int);
+
+	if (size + bakedSize > myMemoryBudget) { //Would evict everything else, and still not fit.
+		return std::shared_ptr<const Mask>();
+	}
+
+	const auto bits = new boost::dynamic_bitset<>(width * height);
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+
+			//The same rounding as the pixel-perfect test.
+
+			const auto u = inverse.xx() * (x + xMin) + inverse.xy() * (y + yMin) + inverse.xc();
+			const auto v = inverse.yx() * (x + xMin) + inverse.yy() * (y + yMin) + inverse.yc();
+
+			if (u > -0.5 && u < imageWidth - 0.5 && v > -0.5 && v < imageHeight - 0.5
+					&& (*binaryImage).hasPoint((unsigned int) (u + 0.5), (unsigned int) (v + 0.5))) {
+				(*bits)[x + y * width] = 1;
+			}
+		}
+	}
+
+	if ((*bits).none()) {
+		delete bits;
+		return std::shared_ptr<const Mask>();
+	}
+
+	const auto rotatedImage = std::shared_ptr<const BitsetBinaryImage>(BitsetBinaryImage::createUnsafe(width, height, bits));
+
+	size += bakedSize;
+
+	//Placed at a position, the point (0, 0) of the baked image is at the position plus (xMin, yMin).
+
+	const auto rotatedMaskNull = Mask::createMaskNullFromBinaryImage(rotatedImage, P(-xMin, -yMin));
+
+	return std::shared_ptr<const Mask>(rotatedMaskNull);
+}
+
+void RotatedMaskCache::clear() {
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	entries.clear();
+	uses.clear();
+	myUsedMemory = 0;
+}
+
+}
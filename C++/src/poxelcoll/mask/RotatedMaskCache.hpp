@@ -0,0 +1,157 @@
+/* RotatedMaskCache.hpp */
+
+/* Copyright (C) 2012 Jens W.-Møller
+ * All rights reserved.
+ *
+ * This file is part of Poxelcoll.
+ *
+ * Poxelcoll is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Poxelcoll is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Poxelcoll.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POXELCOLL_MASK_ROTATEDMASKCACHE_HPP_
+#define POXELCOLL_MASK_ROTATEDMASKCACHE_HPP_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "../DataTypes.hpp"
+#include "../binaryimage/BinaryImage.hpp"
+#include "MaskExtents.hpp"
+
+namespace poxelcoll {
+
+class Mask;
+
+/** \ingroup poxelcoll
+ *
+ * Pre-rotated masks of a binary image, for angles that are whole multiples of a fixed step, such as every 5 degrees.
+ *
+ * A full turn is divided into a number of angle buckets, and the scalings into whole multiples of 1 / scaleSteps.
+ * For an angle on a bucket and a scaling on a step along each axis,
+ * the pre-rotated mask is a bitset binary image of the points of the transformed image,
+ * found by sampling the image at each whole point the same way the pixel-perfect test does.
+ * A collision object whose angle is on a bucket and whose position is whole can then be sampled as only translated,
+ * which reads whole words instead of transforming each point. Other angles are not affected.
+ *
+ * Only the sampling uses the pre-rotated mask. The points that are tested are still found from the hulls
+ * of the original mask, since the hull of the baked points can reach up to half a pixel beyond them,
+ * so whether a pre-rotated mask is at hand never changes an answer.
+ *
+ * The pre-rotated masks are baked lazily, the first time an angle bucket and scaling is asked for.
+ * Once the baked images take up more memory than the budget, the least recently used are forgotten.
+ * An angle bucket and scaling that has no pre-rotated mask, because it would be larger than the budget,
+ * or because the transformation has no inverse or leaves no points on, is remembered as such,
+ * so it is not baked again each time it is asked for.
+ *
+ * The cache is safe to use from several threads at once.
+ */
+class RotatedMaskCache {
+
+private:
+
+	struct Key {
+		int bucket;
+		int scaleX; //In steps of 1 / scaleSteps.
+		int scaleY; //In steps of 1 / scaleSteps.
+
+		const bool operator<(const Key & other) const {
+			return bucket != other.bucket ? bucket < other.bucket :
+					scaleX != other.scaleX ? scaleX < other.scaleX :
+					scaleY < other.scaleY;
+		}
+	};
+
+	struct Entry {
+		std::shared_ptr<const Mask> rotatedMaskNull; //NOTE: Handle potential null. Null if there is no pre-rotated mask.
+		size_t size;
+		std::list<Key>::iterator use;
+	};
+
+	const std::shared_ptr<const BinaryImage> binaryImage;
+	const std::shared_ptr<const MaskExtents> extents;
+	const P origin;
+	const unsigned int myAngleBuckets;
+	const size_t myMemoryBudget;
+
+	mutable std::mutex mutex;
+	mutable std::map<Key, Entry> entries;
+	mutable std::list<Key> uses; //The most recently used first.
+	mutable size_t myUsedMemory;
+
+	/** Bakes the pre-rotated mask of a key.
+	 *
+	 * @param key the angle bucket and scaling
+	 * @param size set to the approximate number of bytes the entry of the key takes up
+	 * @return the pre-rotated mask, or none if the mask alone would be larger than the budget,
+	 *         if the transformation has no inverse, or if no points are on
+	 */
+	const std::shared_ptr<const Mask> bake(const Key & key, size_t & size) const;
+
+public:
+
+	/** The largest difference in radians between an angle and the angle of a bucket for the angle to be on the bucket. */
+	static const double angleTolerance;
+
+	/** The number of scaling steps per unit, such that scalings on a step are whole multiples of 1 / scaleSteps. */
+	static const int scaleSteps = 16;
+
+	/** The largest difference between a scaling and a step for the scaling to be on the step. */
+	static const double scaleTolerance;
+
+	/** The default memory budget in bytes, 4 MiB. */
+	static const size_t defaultMemoryBudget = 4 << 20;
+
+	/**
+	 * @param binaryImage the binary image of the mask
+	 * @param extents the extents of the binary image
+	 * @param origin the origin point of the mask
+	 * @param angleBuckets the strictly positive number of angle buckets per full turn, such as 72 for every 5 degrees
+	 * @param memoryBudget the approximate number of bytes the pre-rotated masks may take up
+	 */
+	RotatedMaskCache(const std::shared_ptr<const BinaryImage> binaryImage,
+			const std::shared_ptr<const MaskExtents> extents, const P origin,
+			const unsigned int angleBuckets, const size_t memoryBudget = defaultMemoryBudget);
+
+	/** @return the number of angle buckets per full turn */
+	const unsigned int angleBuckets() const;
+
+	/** @return the approximate number of bytes the pre-rotated masks may take up */
+	const size_t memoryBudget() const;
+
+	/** @return the approximate number of bytes the pre-rotated masks take up at the moment */
+	const size_t usedMemory() const;
+
+	/** The pre-rotated mask of an angle and a scaling, baking it if it is not already.
+	 *
+	 * The origin of the pre-rotated mask is such that placing it at a position gives the points of
+	 * the original mask transformed by the angle and scaling and placed at the same position,
+	 * as long as the position is whole.
+	 *
+	 * @param angle the angle in radians
+	 * @param scaleX the scaling along the x-axis
+	 * @param scaleY the scaling along the y-axis
+	 * @return the pre-rotated mask, or none if the angle is not on a bucket, if a scaling is not on a step,
+	 *         if the mask alone is larger than the budget, or if the transformation has no inverse or leaves no points on
+	 */
+	const std::shared_ptr<const Mask> rotatedMaskNullOf(const double angle, const double scaleX, const double scaleY) const;
+
+	/** Forgets all pre-rotated masks. */
+	void clear();
+};
+
+}
+
+#endif /* POXELCOLL_MASK_ROTATEDMASKCACHE_HPP_ */